@@ -0,0 +1,530 @@
+#pragma once
+/// -----------------------------------------------------------------------------
+///
+/// BSD 3-Clause License
+/// Copyright(c) 2023-2024, (IHarzI) Maslianka Zakhar
+///
+/// -----------------------------------------------------------------------------
+
+#include "RingBuffer.h"
+
+#include <new>
+#include <utility>
+
+namespace harz {
+	namespace Containers {
+		namespace RingBufferImplementation {
+
+			namespace detail {
+
+				// log2 of a power of two, for turning a chunk size into a lookup shift
+				inline constexpr size_t Log2OfPowerOfTwo(size_t Value)
+				{
+					size_t Shift = 0;
+					while ((size_t(1) << Shift) < Value)
+						Shift++;
+					return Shift;
+				};
+			};
+
+			// FIFO ring over deque-style fixed-size chunks instead of one contiguous block.
+			// A small table of chunk pointers maps the index space, so growing the ring
+			// appends a chunk and reshuffles table entries - pointers, never elements. A
+			// contiguous RingBuffer pays a full-content copy on every growth Resize, which
+			// for multi-gigabyte rings is a latency spike right when traffic steps up;
+			// here the same growth is bounded by the table size plus at most one chunk of
+			// element moves (see Grow), whatever the ring holds.
+			// Element addressing is a shift+mask chunk lookup instead of one add, so pushes
+			// and pops pay one extra indirection - use RingBuffer when capacity is stable.
+			// Single-threaded like RingBuffer, pair it with external locking if shared.
+			// ChunkSize is in elements and must be a power of two.
+			// Allocator Type must have the same contract as for RingBuffer:
+			// Allocate(size_t bytes_to_allocate), Deallocate(void* MemoryToDeallocate)
+			// and be **Copy/Default Constructable**
+#ifdef RING_BUFFER_USE_SIMPLE_ALLOCATOR
+			template<typename ValueT, typename AllocatorT = utils::TEST_SIMPLE_ALLOCATOR_FOR_RING_BUFFER, size_t ChunkSize = 1024>
+#else
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize = 1024>
+#endif
+			class ChunkedRingBuffer
+			{
+				static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0,
+					"ChunkSize must be a power of two for the shift+mask chunk lookup");
+			public:
+
+				ChunkedRingBuffer() = default;
+				ChunkedRingBuffer(const ChunkedRingBuffer& Other);
+				ChunkedRingBuffer(ChunkedRingBuffer&& Other);
+				ChunkedRingBuffer& operator=(const ChunkedRingBuffer& Other);
+				// Capacity is rounded up to a whole number of chunks
+				ChunkedRingBuffer(size_t capacity);
+				~ChunkedRingBuffer();
+
+				// Push element to the back. Grows by appending chunks when full (doubling
+				// the chunk count, so growth work stays amortized constant per push).
+				// Returns slot index of the pushed element for LookAtIndex, or
+				// InvalidIndex if the ring is full and the allocation failed
+				size_t PushBack(ValueT value);
+
+				// Build the element from constructor arguments directly in its slot
+				template<typename... ArgsT>
+				size_t EmplaceBack(ArgsT&&... args);
+
+				// Pop element from the front into OutValue. Returns false if the ring is empty
+				bool PopFront(ValueT& OutValue);
+
+				// Look at the first front element, don't use the pointer after pushes/pops
+				ValueT* PeekFront();
+				const ValueT* PeekFront() const;
+
+				// Look at this index in the container, don't use the pointer after pushes/pops.
+				// NOTE: if index is outside the occupied range or incorrect, return will be nullptr
+				ValueT* LookAtIndex(size_t index);
+				const ValueT* LookAtIndex(size_t index) const;
+
+				// Replace the element at index: destroy it and construct the new one from
+				// the arguments directly in its slot. Bounds-checked like LookAtIndex;
+				// returns the new element, or nullptr for an invalid index
+				template<typename... ArgsT>
+				ValueT* ReplaceAt(size_t index, ArgsT&&... args);
+
+				// Append chunks: O(chunk table) pointer moves and at most one chunk of
+				// element moves to mend the wrap seam, never a full-content copy.
+				// Returns false if an allocation failed (the ring is left untouched)
+				bool Grow(size_t ChunksToAdd);
+
+				// Grow until the ring can hold at least MinCapacity elements
+				bool Reserve(size_t MinCapacity);
+
+				// Release the chunks the occupied range doesn't touch - the shrink half of
+				// a daily traffic cycle. Keeps one chunk so the next push doesn't allocate
+				void ShrinkToFit();
+
+				// Destroy all elements inside. Chunks are kept for reuse
+				void Clear();
+
+				// Get capacity, always a multiple of ChunkSize
+				inline size_t GetCapacity() const { return capacity; };
+
+				// Get number of elements inside
+				inline size_t GetSize() const { return elementsInside; };
+
+				inline bool IsEmpty() const { return elementsInside == 0; };
+				inline bool IsFull() const { return elementsInside == capacity; };
+
+				inline size_t GetChunkCount() const { return chunkCount; };
+				static inline constexpr size_t GetChunkSize() { return ChunkSize; };
+
+				inline const size_t InvalidIndex() const { return size_t(-1); };
+
+#ifdef RING_BUFFER_ENABLE_STATS
+				// Snapshot/reset of the traffic counters, only compiled in with RING_BUFFER_ENABLE_STATS
+				inline RingBufferStats GetStats() const { return stats; };
+				inline void ResetStats() { stats = {}; };
+#endif
+
+			private:
+				static constexpr size_t ChunkShift = detail::Log2OfPowerOfTwo(ChunkSize);
+				static constexpr size_t ChunkMask = ChunkSize - 1;
+
+				// The shift+mask lookup this storage mode is built around
+				inline ValueT* PointToValueAtIndex(size_t index)
+				{
+					return ChunkTable[index >> ChunkShift] + (index & ChunkMask);
+				};
+
+				inline const ValueT* PointToValueAtIndex(size_t index) const
+				{
+					return ChunkTable[index >> ChunkShift] + (index & ChunkMask);
+				};
+
+				inline size_t IncrementIndexWrapped(size_t index) const
+				{
+					return index == capacity - 1 ? 0 : index + 1;
+				};
+
+				// Route allocations through the extended Allocate(size, alignment) contract
+				// when the allocator provides it, same as RingBuffer does for its block
+				inline void* AllocateMemoryBlock(size_t BytesToAllocate)
+				{
+					if constexpr (detail::THasAlignedAllocate<AllocatorT>::value)
+					{
+						constexpr size_t Alignment = alignof(ValueT) > alignof(void*) ? alignof(ValueT) : alignof(void*);
+						return m_InternalAllocator.Allocate(BytesToAllocate, Alignment);
+					}
+					else
+					{
+						return m_InternalAllocator.Allocate(BytesToAllocate);
+					};
+				};
+
+				// Rebuild the chunk table with the old chunks in occupied order (the chunk
+				// holding the head first) followed by NewChunks, and renormalize head/tail
+				// so the occupied range starts inside table slot 0. Chunk placement alone
+				// re-addresses every element except a wrap seam that cuts through the head
+				// chunk itself; those at most ChunkSize - 1 elements are moved into the
+				// first appended chunk, where the renormalized range expects them
+				bool RebuildChunkTable(size_t NewChunkCount, ValueT** NewChunks, size_t NewChunksCount);
+
+				void ReleaseStorage();
+
+#ifdef RING_BUFFER_ENABLE_STATS
+				// Bumps the push-side counters; WrappedSeam marks an insertion that
+				// crossed the physical end of the index space
+				inline void StatsOnPush(bool WrappedSeam)
+				{
+					stats.Pushes++;
+					if (WrappedSeam)
+						stats.Wraps++;
+					if (elementsInside > stats.HighWaterMark)
+						stats.HighWaterMark = elementsInside;
+				};
+#endif
+
+				AllocatorT m_InternalAllocator = AllocatorT{};
+				ValueT** ChunkTable = nullptr;
+				size_t chunkCount = 0;
+				size_t capacity = 0;
+				// Front element to pop; next slot to push is head + elementsInside, wrapped
+				size_t head = 0;
+				size_t tail = 0;
+				size_t elementsInside = 0;
+#ifdef RING_BUFFER_ENABLE_STATS
+				RingBufferStats stats = {};
+#endif
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::ChunkedRingBuffer(size_t capacity)
+			{
+				if (capacity > 0 && capacity != InvalidIndex())
+					Reserve(capacity);
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::ChunkedRingBuffer(const ChunkedRingBuffer& Other)
+			{
+				m_InternalAllocator = Other.m_InternalAllocator;
+				if (Reserve(Other.capacity))
+				{
+					size_t Index = Other.head;
+					for (size_t element = 0; element < Other.elementsInside; element++)
+					{
+						PushBack(*Other.PointToValueAtIndex(Index));
+						Index = Other.IncrementIndexWrapped(Index);
+					};
+				};
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::ChunkedRingBuffer(ChunkedRingBuffer&& Other)
+			{
+				m_InternalAllocator = Other.m_InternalAllocator;
+				ChunkTable = Other.ChunkTable;
+				chunkCount = Other.chunkCount;
+				capacity = Other.capacity;
+				head = Other.head;
+				tail = Other.tail;
+				elementsInside = Other.elementsInside;
+
+				Other.ChunkTable = nullptr;
+				Other.chunkCount = 0;
+				Other.capacity = 0;
+				Other.head = 0;
+				Other.tail = 0;
+				Other.elementsInside = 0;
+				Other.m_InternalAllocator = {};
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			inline ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>& ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::operator=(const ChunkedRingBuffer& Other)
+			{
+				Clear();
+				if (Reserve(Other.capacity))
+				{
+					size_t Index = Other.head;
+					for (size_t element = 0; element < Other.elementsInside; element++)
+					{
+						PushBack(*Other.PointToValueAtIndex(Index));
+						Index = Other.IncrementIndexWrapped(Index);
+					};
+				};
+				return *this;
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::~ChunkedRingBuffer()
+			{
+				ReleaseStorage();
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			size_t ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::PushBack(ValueT value)
+			{
+				return EmplaceBack(std::move(value));
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			template<typename... ArgsT>
+			size_t ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::EmplaceBack(ArgsT&&... args)
+			{
+				if (elementsInside == capacity)
+				{
+					if (!Grow(chunkCount ? chunkCount : 1))
+					{
+						RING_BUFFER_STAT(stats.FailedPushes++)
+						return InvalidIndex();
+					};
+				};
+
+				const size_t IndexForPushedElement = tail;
+				new (PointToValueAtIndex(IndexForPushedElement)) ValueT(std::forward<ArgsT>(args)...);
+				tail = IncrementIndexWrapped(tail);
+				elementsInside++;
+				RING_BUFFER_STAT(StatsOnPush(tail == 0))
+				return IndexForPushedElement;
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			bool ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::PopFront(ValueT& OutValue)
+			{
+				if (!elementsInside)
+					return false;
+
+				ValueT* Item = PointToValueAtIndex(head);
+				OutValue = std::move(*Item);
+				Item->~ValueT();
+				head = IncrementIndexWrapped(head);
+				elementsInside--;
+				RING_BUFFER_STAT(stats.Pops++)
+				if (!elementsInside)
+				{
+					head = 0;
+					tail = 0;
+				};
+				return true;
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			ValueT* ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::PeekFront()
+			{
+				if (!elementsInside)
+					return nullptr;
+				return PointToValueAtIndex(head);
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			const ValueT* ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::PeekFront() const
+			{
+				if (!elementsInside)
+					return nullptr;
+				return PointToValueAtIndex(head);
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			ValueT* ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::LookAtIndex(size_t index)
+			{
+				if (index >= capacity || !elementsInside)
+					return nullptr;
+
+				// Position inside the occupied range counted from the head
+				const size_t Logical = index >= head ? index - head : index + capacity - head;
+				if (Logical >= elementsInside)
+					return nullptr;
+
+				return PointToValueAtIndex(index);
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			const ValueT* ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::LookAtIndex(size_t index) const
+			{
+				if (index >= capacity || !elementsInside)
+					return nullptr;
+
+				const size_t Logical = index >= head ? index - head : index + capacity - head;
+				if (Logical >= elementsInside)
+					return nullptr;
+
+				return PointToValueAtIndex(index);
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			template<typename... ArgsT>
+			ValueT* ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::ReplaceAt(size_t index, ArgsT&&... args)
+			{
+				if (!LookAtIndex(index))
+					return nullptr;
+
+				ValueT* Item = PointToValueAtIndex(index);
+				Item->~ValueT();
+				new (Item) ValueT(std::forward<ArgsT>(args)...);
+				return Item;
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			bool ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::RebuildChunkTable(size_t NewChunkCount, ValueT** NewChunks, size_t NewChunksCount)
+			{
+				ValueT** NewTable = (ValueT**)m_InternalAllocator.Allocate(NewChunkCount * sizeof(ValueT*));
+				if (!NewTable)
+					return false;
+
+				const size_t HeadChunk = chunkCount ? head >> ChunkShift : 0;
+				for (size_t Chunk = 0; Chunk < chunkCount; Chunk++)
+					NewTable[Chunk] = ChunkTable[HeadChunk + Chunk < chunkCount ? HeadChunk + Chunk : HeadChunk + Chunk - chunkCount];
+				for (size_t Chunk = 0; Chunk < NewChunksCount; Chunk++)
+					NewTable[chunkCount + Chunk] = NewChunks[Chunk];
+
+				// Wrap seam through the head chunk itself: the occupied slots below the
+				// head in its own chunk are logically the newest elements, and chunk
+				// placement can't re-address them - move them into the first appended
+				// chunk at the same offsets, where the renormalized range continues
+				const bool Wrapped = elementsInside > capacity - head;
+				if (Wrapped && tail > HeadChunk * ChunkSize)
+				{
+					ValueT* SeamSource = ChunkTable[HeadChunk];
+					ValueT* SeamDestination = NewChunks[0];
+					const size_t SeamCount = tail - HeadChunk * ChunkSize;
+					if constexpr (std::is_trivially_copyable_v<ValueT>)
+					{
+						detail::CopyMemory(SeamSource, SeamDestination, SeamCount * sizeof(ValueT));
+					}
+					else
+					{
+						for (size_t element = 0; element < SeamCount; element++)
+						{
+							new (SeamDestination + element) ValueT(std::move(SeamSource[element]));
+							SeamSource[element].~ValueT();
+						};
+					};
+				};
+
+				if (ChunkTable)
+					m_InternalAllocator.Deallocate(ChunkTable);
+
+				ChunkTable = NewTable;
+				chunkCount = NewChunkCount;
+				capacity = NewChunkCount << ChunkShift;
+				head = head & ChunkMask;
+				tail = head + elementsInside < capacity ? head + elementsInside : head + elementsInside - capacity;
+				return true;
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			bool ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::Grow(size_t ChunksToAdd)
+			{
+				if (!ChunksToAdd || chunkCount + ChunksToAdd < chunkCount)
+					return false;
+
+				// All-or-nothing: allocate everything up front, the ring is untouched on failure
+				ValueT** NewChunks = (ValueT**)m_InternalAllocator.Allocate(ChunksToAdd * sizeof(ValueT*));
+				if (!NewChunks)
+					return false;
+
+				for (size_t Chunk = 0; Chunk < ChunksToAdd; Chunk++)
+				{
+					NewChunks[Chunk] = (ValueT*)AllocateMemoryBlock(ChunkSize * sizeof(ValueT));
+					if (!NewChunks[Chunk])
+					{
+						for (size_t Allocated = 0; Allocated < Chunk; Allocated++)
+							m_InternalAllocator.Deallocate(NewChunks[Allocated]);
+						m_InternalAllocator.Deallocate(NewChunks);
+						return false;
+					};
+				};
+
+				if (!RebuildChunkTable(chunkCount + ChunksToAdd, NewChunks, ChunksToAdd))
+				{
+					for (size_t Chunk = 0; Chunk < ChunksToAdd; Chunk++)
+						m_InternalAllocator.Deallocate(NewChunks[Chunk]);
+					m_InternalAllocator.Deallocate(NewChunks);
+					return false;
+				};
+
+				m_InternalAllocator.Deallocate(NewChunks);
+				RING_BUFFER_STAT(stats.Resizes++)
+				return true;
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			bool ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::Reserve(size_t MinCapacity)
+			{
+				if (MinCapacity == InvalidIndex())
+					return false;
+				if (MinCapacity <= capacity)
+					return true;
+
+				const size_t ChunksNeeded = (MinCapacity - capacity + ChunkSize - 1) >> ChunkShift;
+				return Grow(ChunksNeeded);
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			void ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::ShrinkToFit()
+			{
+				if (chunkCount <= 1)
+					return;
+
+				// Chunks the occupied range will touch once it starts inside table slot 0.
+				// A seam through the head chunk only happens on a nearly full ring, and
+				// then ChunksNeeded already covers the whole table - nothing to release
+				const size_t ChunksNeeded = elementsInside ? ((head & ChunkMask) + elementsInside + ChunkSize - 1) >> ChunkShift : 1;
+				if (ChunksNeeded >= chunkCount)
+					return;
+
+				ValueT** NewTable = (ValueT**)m_InternalAllocator.Allocate(ChunksNeeded * sizeof(ValueT*));
+				if (!NewTable)
+					return;
+
+				const size_t HeadChunk = head >> ChunkShift;
+				for (size_t Chunk = 0; Chunk < chunkCount; Chunk++)
+				{
+					ValueT* ChunkPointer = ChunkTable[HeadChunk + Chunk < chunkCount ? HeadChunk + Chunk : HeadChunk + Chunk - chunkCount];
+					if (Chunk < ChunksNeeded)
+						NewTable[Chunk] = ChunkPointer;
+					else
+						m_InternalAllocator.Deallocate(ChunkPointer);
+				};
+
+				m_InternalAllocator.Deallocate(ChunkTable);
+				ChunkTable = NewTable;
+				chunkCount = ChunksNeeded;
+				capacity = ChunksNeeded << ChunkShift;
+				head = head & ChunkMask;
+				tail = head + elementsInside < capacity ? head + elementsInside : head + elementsInside - capacity;
+				RING_BUFFER_STAT(stats.Resizes++)
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			void ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::Clear()
+			{
+				if constexpr (!std::is_trivially_destructible_v<ValueT>)
+				{
+					size_t Index = head;
+					for (size_t element = 0; element < elementsInside; element++)
+					{
+						PointToValueAtIndex(Index)->~ValueT();
+						Index = IncrementIndexWrapped(Index);
+					};
+				};
+				head = 0;
+				tail = 0;
+				elementsInside = 0;
+			};
+
+			template<typename ValueT, typename AllocatorT, size_t ChunkSize>
+			void ChunkedRingBuffer<ValueT, AllocatorT, ChunkSize>::ReleaseStorage()
+			{
+				if (!ChunkTable)
+					return;
+
+				Clear();
+				for (size_t Chunk = 0; Chunk < chunkCount; Chunk++)
+					m_InternalAllocator.Deallocate(ChunkTable[Chunk]);
+				m_InternalAllocator.Deallocate(ChunkTable);
+				ChunkTable = nullptr;
+				chunkCount = 0;
+				capacity = 0;
+			};
+
+		};
+	};
+};
@@ -0,0 +1,439 @@
+#pragma once
+/// -----------------------------------------------------------------------------
+///
+/// BSD 3-Clause License
+/// Copyright(c) 2023-2024, (IHarzI) Maslianka Zakhar
+///
+/// -----------------------------------------------------------------------------
+
+#include "RingBuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace harz {
+	namespace Containers {
+		namespace RingBufferImplementation {
+
+			// Multi Producer/Multi Consumer bounded lock-free queue on top of the ring buffer
+			// storage layout (Vyukov-style per-slot sequence numbers). Any number of threads may
+			// call TryPush and TryPop concurrently, neither ever blocks - on a full/empty queue
+			// they just return false. Capacity is rounded up to a power of two so slot mapping
+			// is a mask, same rule as the Pow2Capacity mode of RingBuffer.
+			// Allocator Type must have the same contract as for RingBuffer:
+			// Allocate(size_t bytes_to_allocate), Deallocate(void* MemoryToDeallocate)
+			// and be **Copy/Default Constructable**
+			// Value Type must be movable
+#ifdef RING_BUFFER_USE_SIMPLE_ALLOCATOR
+			template<typename ValueT, typename AllocatorT = utils::TEST_SIMPLE_ALLOCATOR_FOR_RING_BUFFER>
+#else
+			template<typename ValueT, typename AllocatorT>
+#endif
+			class MPMCRingBuffer
+			{
+			public:
+				MPMCRingBuffer();
+				MPMCRingBuffer(size_t capacity);
+				~MPMCRingBuffer();
+
+				// Not copyable/movable, other threads could be touching the queue while we copy it
+				MPMCRingBuffer(const MPMCRingBuffer&) = delete;
+				MPMCRingBuffer& operator=(const MPMCRingBuffer&) = delete;
+
+				// Push element into the queue. Safe to call from any thread.
+				// Returns false if the queue is full
+				bool TryPush(ValueT value);
+
+				// Pop the oldest element into OutValue. Safe to call from any thread.
+				// Returns false if the queue is empty
+				bool TryPop(ValueT& OutValue);
+
+				// Blocking variants: spin briefly with detail::SpinPause, then park on a
+				// condition variable until the queue makes progress or the timeout passes.
+				// The mutex is only ever touched by a thread about to sleep (or waking
+				// one that does), so the lock-free fast path stays lock-free.
+				// Safe to call from any thread, return false on timeout
+				template<typename RepT, typename PeriodT>
+				bool WaitPush(ValueT value, const std::chrono::duration<RepT, PeriodT>& Timeout);
+
+				template<typename RepT, typename PeriodT>
+				bool WaitPop(ValueT& OutValue, const std::chrono::duration<RepT, PeriodT>& Timeout);
+
+				// Get capacity (rounded up to a power of two at construction)
+				inline size_t GetCapacity() const { return capacity; };
+
+				// Get number of elements inside. Only an estimate while other threads are pushing/popping
+				inline size_t GetSize() const
+				{
+					const size_t Enqueued = enqueuePos.load(std::memory_order_acquire);
+					const size_t Dequeued = dequeuePos.load(std::memory_order_acquire);
+					return Enqueued > Dequeued ? Enqueued - Dequeued : 0;
+				};
+
+				inline bool IsEmpty() const { return GetSize() == 0; };
+
+				// Reallocate the queue with a new capacity (rounded up to a power of two).
+				// NOT thread safe, every producer and consumer must be stopped.
+				// Could fail, if allocator couldn't allocate enough memory
+				bool Resize(size_t NewCapacity);
+
+				// Destroy all elements inside. NOT thread safe, see Resize
+				void Clear();
+
+				inline const size_t InvalidIndex() const { return size_t(-1); };
+
+#ifdef RING_BUFFER_ENABLE_STATS
+				// Snapshot/reset of the traffic counters, only compiled in with RING_BUFFER_ENABLE_STATS.
+				// Counters are bumped with relaxed atomics from whichever thread did the work,
+				// GetStats may be called from any thread
+				inline RingBufferStats GetStats() const { return stats.Snapshot(); };
+				inline void ResetStats() { stats.Reset(); };
+#endif
+
+			private:
+				struct Cell
+				{
+					std::atomic<size_t> Sequence;
+					alignas(alignof(ValueT)) unsigned char Storage[sizeof(ValueT)];
+
+					inline ValueT* ValuePtr() { return (ValueT*)Storage; };
+				};
+
+				static const size_t CacheLineSize = RING_BUFFER_CACHE_LINE_SIZE;
+				// Spins taken before a Wait* call parks; roughly a microsecond of
+				// polling, which catches almost every message on a busy queue
+				static const size_t SpinsBeforeWait = 1024;
+
+				Cell* AllocateCells(size_t CellsCount);
+				void ReleaseCells(Cell* Cells, size_t CellsCount, size_t DequeuedPos, size_t EnqueuedPos);
+
+				AllocatorT m_InternalAllocator = AllocatorT{};
+				Cell* CellsBlock = nullptr;
+				size_t capacity = 0;
+				size_t capacityMask = 0;
+
+				// Producers and consumers claim monotonically growing positions, each kept on its
+				// own cache line; the per-cell Sequence decides when a claimed slot is usable
+				alignas(CacheLineSize) std::atomic<size_t> enqueuePos = 0;
+				alignas(CacheLineSize) std::atomic<size_t> dequeuePos = 0;
+				char PadAfterPositions[CacheLineSize - sizeof(std::atomic<size_t>)] = {};
+
+				// Blocking support: a sleeper raises its flag, publishes it with a full
+				// fence, re-checks the queue and only then waits; the opposite side fences
+				// after its CAS and notifies whenever it sees a raised flag
+				std::mutex waitMutex;
+				std::condition_variable waitCondition;
+				std::atomic<size_t> waitingConsumers = 0;
+				std::atomic<size_t> waitingProducers = 0;
+
+#ifdef RING_BUFFER_ENABLE_STATS
+				RingBufferAtomicStats stats = {};
+#endif
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			MPMCRingBuffer<ValueT, AllocatorT>::MPMCRingBuffer()
+			{
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			MPMCRingBuffer<ValueT, AllocatorT>::MPMCRingBuffer(size_t capacity)
+			{
+				if (capacity > 0 && capacity != InvalidIndex())
+				{
+					const size_t CellsCount = detail::RoundUpToPowerOfTwo(capacity);
+					CellsBlock = AllocateCells(CellsCount);
+					if (CellsBlock)
+					{
+						this->capacity = CellsCount;
+						capacityMask = CellsCount - 1;
+					}
+				};
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			MPMCRingBuffer<ValueT, AllocatorT>::~MPMCRingBuffer()
+			{
+				if (CellsBlock)
+				{
+					ReleaseCells(CellsBlock, capacity, dequeuePos.load(std::memory_order_relaxed),
+						enqueuePos.load(std::memory_order_relaxed));
+				}
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			MPMCRingBuffer<ValueT, AllocatorT>::Cell* MPMCRingBuffer<ValueT, AllocatorT>::AllocateCells(size_t CellsCount)
+			{
+				Cell* Cells = (Cell*)m_InternalAllocator.Allocate(CellsCount * sizeof(Cell));
+				if (Cells)
+				{
+					for (size_t CellIndex = 0; CellIndex < CellsCount; CellIndex++)
+					{
+						// Each cell starts out expecting the producer of its first lap
+						new (&Cells[CellIndex].Sequence) std::atomic<size_t>(CellIndex);
+					};
+				};
+				return Cells;
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			void MPMCRingBuffer<ValueT, AllocatorT>::ReleaseCells(Cell* Cells, size_t CellsCount, size_t DequeuedPos, size_t EnqueuedPos)
+			{
+				// Destroy whatever is still enqueued, then give the block back
+				for (size_t Pos = DequeuedPos; Pos < EnqueuedPos; Pos++)
+				{
+					Cells[Pos & (CellsCount - 1)].ValuePtr()->~ValueT();
+				};
+				m_InternalAllocator.Deallocate(Cells);
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			bool MPMCRingBuffer<ValueT, AllocatorT>::TryPush(ValueT value)
+			{
+				if (!CellsBlock)
+					return false;
+
+				size_t Pos = enqueuePos.load(std::memory_order_relaxed);
+				for (;;)
+				{
+					Cell* ClaimedCell = &CellsBlock[Pos & capacityMask];
+					const size_t Sequence = ClaimedCell->Sequence.load(std::memory_order_acquire);
+
+					if (Sequence == Pos)
+					{
+						// Cell is free on this lap, try to claim the position
+						if (enqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+						{
+							new (ClaimedCell->ValuePtr()) ValueT(std::move(value));
+							// Hand the cell over to the consumer of this lap
+							ClaimedCell->Sequence.store(Pos + 1, std::memory_order_release);
+							RING_BUFFER_STAT(stats.Pushes.fetch_add(1, std::memory_order_relaxed))
+							RING_BUFFER_STAT(if ((Pos & capacityMask) == capacityMask) stats.Wraps.fetch_add(1, std::memory_order_relaxed))
+							RING_BUFFER_STAT(stats.UpdateHighWaterMark(GetSize()))
+
+							// The published cell must be visible before the flag check, or a
+							// consumer parking right now could miss our notify
+							std::atomic_thread_fence(std::memory_order_seq_cst);
+							if (waitingConsumers.load(std::memory_order_relaxed))
+							{
+								// Empty lock/unlock closes the race with a consumer between
+								// its re-check and its wait
+								{ std::lock_guard<std::mutex> Lock(waitMutex); };
+								waitCondition.notify_one();
+							};
+
+							return true;
+						};
+						// CAS failed, Pos was reloaded - retry with the new position
+					}
+					else if (Sequence < Pos)
+					{
+						// Cell still holds an unconsumed element from a lap ago - queue is full
+						RING_BUFFER_STAT(stats.FailedPushes.fetch_add(1, std::memory_order_relaxed))
+						return false;
+					}
+					else
+					{
+						// Another producer already claimed this position, catch up
+						Pos = enqueuePos.load(std::memory_order_relaxed);
+					};
+				};
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			bool MPMCRingBuffer<ValueT, AllocatorT>::TryPop(ValueT& OutValue)
+			{
+				if (!CellsBlock)
+					return false;
+
+				size_t Pos = dequeuePos.load(std::memory_order_relaxed);
+				for (;;)
+				{
+					Cell* ClaimedCell = &CellsBlock[Pos & capacityMask];
+					const size_t Sequence = ClaimedCell->Sequence.load(std::memory_order_acquire);
+
+					if (Sequence == Pos + 1)
+					{
+						// Cell was published for this lap, try to claim the position
+						if (dequeuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+						{
+							ValueT* Item = ClaimedCell->ValuePtr();
+							OutValue = std::move(*Item);
+							Item->~ValueT();
+							// Recycle the cell for the producer one lap ahead
+							ClaimedCell->Sequence.store(Pos + capacity, std::memory_order_release);
+							RING_BUFFER_STAT(stats.Pops.fetch_add(1, std::memory_order_relaxed))
+
+							// Mirror of the push side - wake a producer parked on a full queue
+							std::atomic_thread_fence(std::memory_order_seq_cst);
+							if (waitingProducers.load(std::memory_order_relaxed))
+							{
+								{ std::lock_guard<std::mutex> Lock(waitMutex); };
+								waitCondition.notify_one();
+							};
+
+							return true;
+						};
+					}
+					else if (Sequence < Pos + 1)
+					{
+						// Producer hasn't published this position yet - queue is empty
+						return false;
+					}
+					else
+					{
+						// Another consumer already claimed this position, catch up
+						Pos = dequeuePos.load(std::memory_order_relaxed);
+					};
+				};
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			template<typename RepT, typename PeriodT>
+			bool MPMCRingBuffer<ValueT, AllocatorT>::WaitPush(ValueT value, const std::chrono::duration<RepT, PeriodT>& Timeout)
+			{
+				if (!CellsBlock)
+					return false;
+
+				// Fast path - on a queue that drains at all, a cell frees up while spinning
+				for (size_t Spin = 0; Spin < SpinsBeforeWait; Spin++)
+				{
+					if (TryPush(value))
+						return true;
+					detail::SpinPause();
+				};
+
+				const auto Deadline = std::chrono::steady_clock::now() + Timeout;
+				for (;;)
+				{
+					bool TimedOut = false;
+					{
+						std::unique_lock<std::mutex> Lock(waitMutex);
+						waitingProducers.fetch_add(1, std::memory_order_relaxed);
+						// The raised flag must be visible before the re-check below, or a pop
+						// landing in between could skip its notify and leave us sleeping
+						std::atomic_thread_fence(std::memory_order_seq_cst);
+
+						while (GetSize() >= capacity && !TimedOut)
+							TimedOut = waitCondition.wait_until(Lock, Deadline) == std::cv_status::timeout;
+
+						waitingProducers.fetch_sub(1, std::memory_order_relaxed);
+					};
+
+					// Unlike the SPSC ring another producer may grab the freed cell first,
+					// so a failed retry just parks again until the deadline
+					if (TryPush(value))
+						return true;
+					if (TimedOut)
+						return false;
+				};
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			template<typename RepT, typename PeriodT>
+			bool MPMCRingBuffer<ValueT, AllocatorT>::WaitPop(ValueT& OutValue, const std::chrono::duration<RepT, PeriodT>& Timeout)
+			{
+				if (!CellsBlock)
+					return false;
+
+				// Fast path - on a busy queue almost every message is caught while spinning
+				for (size_t Spin = 0; Spin < SpinsBeforeWait; Spin++)
+				{
+					if (TryPop(OutValue))
+						return true;
+					detail::SpinPause();
+				};
+
+				const auto Deadline = std::chrono::steady_clock::now() + Timeout;
+				for (;;)
+				{
+					bool TimedOut = false;
+					{
+						std::unique_lock<std::mutex> Lock(waitMutex);
+						waitingConsumers.fetch_add(1, std::memory_order_relaxed);
+						// See WaitPush - flag first, then re-check, then sleep
+						std::atomic_thread_fence(std::memory_order_seq_cst);
+
+						while (IsEmpty() && !TimedOut)
+							TimedOut = waitCondition.wait_until(Lock, Deadline) == std::cv_status::timeout;
+
+						waitingConsumers.fetch_sub(1, std::memory_order_relaxed);
+					};
+
+					// Another consumer may grab the element first, so a failed retry
+					// just parks again until the deadline
+					if (TryPop(OutValue))
+						return true;
+					if (TimedOut)
+						return false;
+				};
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			bool MPMCRingBuffer<ValueT, AllocatorT>::Resize(size_t NewCapacity)
+			{
+				if (NewCapacity == 0 || NewCapacity == InvalidIndex())
+					return false;
+
+				const size_t CellsCount = detail::RoundUpToPowerOfTwo(NewCapacity);
+				const size_t ElementsInside = GetSize();
+				if (CellsCount < ElementsInside)
+					return false;
+
+				Cell* NewCells = AllocateCells(CellsCount);
+				if (!NewCells)
+					return false;
+
+				// Move the still-enqueued elements over, oldest first
+				size_t NewPos = 0;
+				if (CellsBlock)
+				{
+					const size_t Dequeued = dequeuePos.load(std::memory_order_relaxed);
+					const size_t Enqueued = enqueuePos.load(std::memory_order_relaxed);
+					for (size_t Pos = Dequeued; Pos < Enqueued; Pos++)
+					{
+						ValueT* Item = CellsBlock[Pos & capacityMask].ValuePtr();
+						new (NewCells[NewPos & (CellsCount - 1)].ValuePtr()) ValueT(std::move(*Item));
+						Item->~ValueT();
+						NewCells[NewPos & (CellsCount - 1)].Sequence.store(NewPos + 1, std::memory_order_relaxed);
+						NewPos++;
+					};
+					m_InternalAllocator.Deallocate(CellsBlock);
+				};
+
+				CellsBlock = NewCells;
+				capacity = CellsCount;
+				capacityMask = CellsCount - 1;
+				dequeuePos.store(0, std::memory_order_relaxed);
+				enqueuePos.store(NewPos, std::memory_order_relaxed);
+				RING_BUFFER_STAT(stats.Resizes.fetch_add(1, std::memory_order_relaxed))
+				return true;
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			void MPMCRingBuffer<ValueT, AllocatorT>::Clear()
+			{
+				if (!CellsBlock)
+					return;
+
+				const size_t Dequeued = dequeuePos.load(std::memory_order_relaxed);
+				const size_t Enqueued = enqueuePos.load(std::memory_order_relaxed);
+				for (size_t Pos = Dequeued; Pos < Enqueued; Pos++)
+				{
+					CellsBlock[Pos & capacityMask].ValuePtr()->~ValueT();
+				};
+				for (size_t CellIndex = 0; CellIndex < capacity; CellIndex++)
+				{
+					CellsBlock[CellIndex].Sequence.store(CellIndex, std::memory_order_relaxed);
+				};
+				dequeuePos.store(0, std::memory_order_relaxed);
+				enqueuePos.store(0, std::memory_order_relaxed);
+			};
+
+		};
+	};
+};
@@ -7,6 +7,10 @@
 /// -----------------------------------------------------------------------------
 
 #include <vector>
+#include <type_traits>
+#include <utility>
+#include <iterator>
+#include <new>
 #include <memory.h>
 #include <intrin.h>
 
@@ -19,6 +23,35 @@
 #define RING_BUFFER_REPORT(msg)
 #endif
 
+// SSE2 is always there on x86/x64 targets, used for the vectorized search paths
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define RING_BUFFER_SIMD_SSE2 1
+#else
+#define RING_BUFFER_SIMD_SSE2 0
+#endif
+
+// One cache line, shared by the alignment and anti-false-sharing knobs across
+// the containers. Override before including if the target's line size differs
+#ifndef RING_BUFFER_CACHE_LINE_SIZE
+#define RING_BUFFER_CACHE_LINE_SIZE 64
+#endif
+
+// MSVC only honors its vendor spelling of no_unique_address
+#if defined(_MSC_VER) && !defined(__clang__)
+#define RING_BUFFER_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define RING_BUFFER_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+// Opt-in occupancy/traffic counters on the hot paths, see RingBufferStats.
+// Without the macro every stats statement compiles away to nothing
+#ifdef RING_BUFFER_ENABLE_STATS
+#include <atomic>
+#define RING_BUFFER_STAT(expression) expression;
+#else
+#define RING_BUFFER_STAT(expression)
+#endif
+
 #pragma once
 
 namespace harz {
@@ -42,6 +75,13 @@ namespace harz {
 				ContainerT* Container;
 			public:
 
+				/** std::iterator_traits support, distance and offsets are O(1) over the ring */
+				using iterator_category = std::random_access_iterator_tag;
+				using value_type = ValueT;
+				using difference_type = std::ptrdiff_t;
+				using pointer = std::conditional_t<IsConstAccessOnly, const ValueT*, ValueT*>;
+				using reference = std::conditional_t<IsConstAccessOnly, const ValueT&, ValueT&>;
+
 				TIndexedIteratorBase(const ContainerT& InContainer, SizeType StartIndex = InContainer.GetBeginIndex(),
 					EIndexedAccessIteratorPosition Pos = EIndexedAccessIteratorPosition::Begin);
 
@@ -248,26 +288,32 @@ namespace harz {
 					return *this;
 				}				
 
-				/** iterator arithmetic support */
-				TIndexedIteratorBase& operator+=(SizeType Offset)
+				/** iterator arithmetic support, negative offsets walk backwards */
+				TIndexedIteratorBase& operator+=(difference_type Offset)
 				{
-					Increment(Offset);
+					if (Offset < 0)
+						Decrement((SizeType)(-Offset));
+					else
+						Increment((SizeType)Offset);
 
 					RING_BUFFER_ASSERT(*this == GetContainerRef().end() || Index != GetContainerRef().InvalidIndex());
 
 					return *this;
 				}
 
-				TIndexedIteratorBase operator+(SizeType Offset) const
+				TIndexedIteratorBase operator+(difference_type Offset) const
 				{
 					TIndexedIteratorBase Tmp(*this);
 					Tmp += Offset;
 					return Tmp;
 				}
 
-				TIndexedIteratorBase& operator-=(SizeType Offset)
+				TIndexedIteratorBase& operator-=(difference_type Offset)
 				{
-					Decrement(Offset);
+					if (Offset < 0)
+						Increment((SizeType)(-Offset));
+					else
+						Decrement((SizeType)Offset);
 
 					//if (Index == GetContainerRef().InvalidIndex())
 					//	Position = EIndexedAccessIteratorPosition::Begin;
@@ -276,13 +322,46 @@ namespace harz {
 					return *this;
 				}
 
-				TIndexedIteratorBase operator-(SizeType Offset) const
+				TIndexedIteratorBase operator-(difference_type Offset) const
 				{
 					TIndexedIteratorBase Tmp(*this);
 					Tmp -= Offset;
 					return Tmp;
 				}
 
+				/** Logical position counted from begin, size() for the end iterator. O(1) */
+				SizeType LogicalIndex() const
+				{
+					switch (Position)
+					{
+					case EIndexedAccessIteratorPosition::Begin:
+						return 0;
+					case EIndexedAccessIteratorPosition::End:
+						return GetContainerRef().size();
+					default:
+						return GetContainerRef().GetLogicalIndex(Index);
+					};
+				}
+
+				/** O(1) distance between two iterators over the same container, for std algorithms */
+				difference_type operator-(const TIndexedIteratorBase& Rhs) const
+				{
+					RING_BUFFER_ASSERT(Container == Rhs.Container);
+					return (difference_type)LogicalIndex() - (difference_type)Rhs.LogicalIndex();
+				}
+
+				inline bool operator<(const TIndexedIteratorBase& Rhs) const { return LogicalIndex() < Rhs.LogicalIndex(); };
+				inline bool operator>(const TIndexedIteratorBase& Rhs) const { return LogicalIndex() > Rhs.LogicalIndex(); };
+				inline bool operator<=(const TIndexedIteratorBase& Rhs) const { return LogicalIndex() <= Rhs.LogicalIndex(); };
+				inline bool operator>=(const TIndexedIteratorBase& Rhs) const { return LogicalIndex() >= Rhs.LogicalIndex(); };
+
+				inline const ValueT& operator[](difference_type Offset) const { return *(*this + Offset); };
+
+				template <typename = std::enable_if<!IsConstAccessOnly>::type> ValueT& operator[](difference_type Offset)
+				{
+					return *(*this + Offset);
+				}
+
 				/** conversion to "bool" returning true if the iterator has not reached the last element. */
 				inline explicit operator bool() const
 				{
@@ -298,7 +377,7 @@ namespace harz {
 				/** Returns an index to the current element. */
 				SizeType GetIndex() const
 				{
-					return Position = EIndexedAccessIteratorPosition::InRange ? Index : GetContainerRef().InvalidIndex();
+					return Position == EIndexedAccessIteratorPosition::InRange ? Index : GetContainerRef().InvalidIndex();
 				}
 
 				/** Resets the iterator to the first element. */
@@ -317,12 +396,14 @@ namespace harz {
 					Position = EndIter.Position;
 				}
 
+				// Positional equality, so an iterator walked back to the first element
+				// compares equal to begin() even though one was tagged Begin and the other InRange
 				inline bool operator==(const TIndexedIteratorBase& Rhs) const {
-					return Container == Rhs.Container && Index == Rhs.Index && Position == Rhs.Position;
+					return Container == Rhs.Container && LogicalIndex() == Rhs.LogicalIndex();
 				};
 
 				inline bool operator!=(const TIndexedIteratorBase& Rhs) const {
-					return Container != Rhs.Container || Index != Rhs.Index || Position != Rhs.Position;
+					return Container != Rhs.Container || LogicalIndex() != Rhs.LogicalIndex();
 				};
 				protected:
 
@@ -380,22 +461,307 @@ namespace harz {
 };
 #endif
 
+#ifdef RING_BUFFER_USE_HUGE_PAGE_ALLOCATOR
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <cstdlib>
+#include <sys/mman.h>
+#endif
+
+namespace harz {
+	namespace utils {
+
+		// Allocator implementing the extended aligned contract. Blocks of 2MB and up are
+		// backed by huge pages (one dTLB entry covers the whole ring instead of hundreds
+		// of 4KB ones), smaller blocks take the regular page path. On Windows large pages
+		// need SeLockMemoryPrivilege - when that (or the large-page pool) is missing the
+		// allocation silently falls back to regular pages
+		class HugePageAllocator
+		{
+
+		public:
+			using pointer = void*;
+
+			static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+			inline pointer Allocate(size_t allocationsize)
+			{
+				return Allocate(allocationsize, alignof(max_align_t));
+			};
+
+			inline pointer Allocate(size_t allocationsize, size_t alignment)
+			{
+				// Huge pages are always page aligned, so any sane alignment request
+				// is satisfied for free on that path
+#if defined(_WIN32)
+				if (allocationsize >= HugePageSize)
+				{
+					const size_t RoundedSize = (allocationsize + HugePageSize - 1) & ~(HugePageSize - 1);
+					pointer allocation = VirtualAlloc(NULL, RoundedSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+					if (allocation)
+					{
+						RING_BUFFER_REPORT(" HUGE PAGE ALLOCATOR ALLOCATED LARGE PAGES AT ADDRESS: " << allocation);
+						return allocation;
+					};
+				};
+				pointer allocation = VirtualAlloc(NULL, allocationsize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+				pointer allocation = nullptr;
+				if (allocationsize >= HugePageSize)
+				{
+					const size_t RoundedSize = (allocationsize + HugePageSize - 1) & ~(HugePageSize - 1);
+					allocation = std::aligned_alloc(HugePageSize, RoundedSize);
+					if (allocation)
+					{
+						// Ask the kernel to back the range with transparent huge pages
+						madvise(allocation, RoundedSize, MADV_HUGEPAGE);
+						RING_BUFFER_REPORT(" HUGE PAGE ALLOCATOR ALLOCATED LARGE PAGES AT ADDRESS: " << allocation);
+						return allocation;
+					};
+				};
+				// aligned_alloc wants the size to be a multiple of the alignment
+				allocation = std::aligned_alloc(alignment, (allocationsize + alignment - 1) & ~(alignment - 1));
+#endif
+				RING_BUFFER_REPORT(" HUGE PAGE ALLOCATOR ALLOCATED AT ADDRESS: " << allocation);
+				return allocation;
+			};
+
+			inline bool Deallocate(void* allocation)
+			{
+				RING_BUFFER_REPORT(" HUGE PAGE ALLOCATOR CALL TO DEALLOCATE AT ADDRESS: " << allocation);
+#if defined(_WIN32)
+				return VirtualFree(allocation, 0, MEM_RELEASE) != 0;
+#else
+				std::free(allocation);
+				return true;
+#endif
+			};
+		};
+	};
+};
+#endif
+
 namespace harz {
 	namespace Containers {
 		namespace RingBufferImplementation {
 			namespace detail {
 				inline static void* CopyMemory(void* src, void* dst, size_t size) { memcpy_s(dst, size, src, size);	return dst; };
+
+				// Padding block for the PaddedLayout ring mode - specializes to an empty
+				// type when disabled, so with RING_BUFFER_NO_UNIQUE_ADDRESS the default
+				// layout doesn't pay a byte for it. Tag keeps multiple pads distinct types
+				template<bool Enabled, size_t Tag>
+				struct TCacheLinePad { char Pad[RING_BUFFER_CACHE_LINE_SIZE] = {}; };
+				template<size_t Tag>
+				struct TCacheLinePad<false, Tag> {};
+
+				inline static size_t RoundUpToPowerOfTwo(size_t value)
+				{
+					if (value <= 1)
+						return 1;
+					value--;
+					value |= value >> 1;
+					value |= value >> 2;
+					value |= value >> 4;
+					value |= value >> 8;
+					value |= value >> 16;
+					if (sizeof(size_t) > 4)
+						value |= value >> 32;
+					return value + 1;
+				};
+
+				// One step of a busy-wait loop - tells the core it is spinning so it
+				// frees pipeline resources for the sibling hyperthread
+				inline static void SpinPause()
+				{
+#if RING_BUFFER_SIMD_SSE2
+					_mm_pause();
+#endif
+				};
+
+				// Hint the line at Address into L1 ahead of its use; compiles away to
+				// nothing off x86
+				inline static void PrefetchForRead(const void* Address)
+				{
+#if RING_BUFFER_SIMD_SSE2
+					_mm_prefetch((const char*)Address, _MM_HINT_T0);
+#endif
+				};
+
+				// Detects the extended aligned allocation contract:
+				// Allocate(size_t bytes_to_allocate, size_t alignment).
+				// Allocators with only the plain Allocate(size_t) keep working unchanged
+				template<typename AllocatorT, typename = void>
+				struct THasAlignedAllocate : std::false_type {};
+
+				template<typename AllocatorT>
+				struct THasAlignedAllocate<AllocatorT,
+					std::void_t<decltype(std::declval<AllocatorT&>().Allocate(size_t(0), size_t(0)))>> : std::true_type {};
+
+#if RING_BUFFER_SIMD_SSE2
+				// Vectorized first-match search in [First, Last) for 1/2/4 byte integral values,
+				// 16 bytes per step with a scalar tail
+				template<typename ValueT>
+				inline static const ValueT* FindValueSSE2(const ValueT* First, const ValueT* Last, ValueT Value)
+				{
+					constexpr size_t LanesPerVector = 16 / sizeof(ValueT);
+
+					__m128i Needle;
+					if constexpr (sizeof(ValueT) == 1)
+						Needle = _mm_set1_epi8((char)Value);
+					else if constexpr (sizeof(ValueT) == 2)
+						Needle = _mm_set1_epi16((short)Value);
+					else
+						Needle = _mm_set1_epi32((int)Value);
+
+					while (First + LanesPerVector <= Last)
+					{
+						const __m128i Chunk = _mm_loadu_si128((const __m128i*)First);
+						__m128i Equal;
+						if constexpr (sizeof(ValueT) == 1)
+							Equal = _mm_cmpeq_epi8(Chunk, Needle);
+						else if constexpr (sizeof(ValueT) == 2)
+							Equal = _mm_cmpeq_epi16(Chunk, Needle);
+						else
+							Equal = _mm_cmpeq_epi32(Chunk, Needle);
+
+						if (_mm_movemask_epi8(Equal))
+						{
+							for (size_t Lane = 0; Lane < LanesPerVector; Lane++)
+							{
+								if (First[Lane] == Value)
+									return First + Lane;
+							};
+						};
+						First += LanesPerVector;
+					};
+
+					for (; First < Last; First++)
+					{
+						if (*First == Value)
+							return First;
+					};
+
+					return nullptr;
+				};
+#endif
+
+				// First-match search in [First, Last), takes the SSE2 path for small integral
+				// values and a plain operator== loop for everything else
+				template<typename ValueT>
+				inline static const ValueT* FindValueInRange(const ValueT* First, const ValueT* Last, const ValueT& Value)
+				{
+#if RING_BUFFER_SIMD_SSE2
+					if constexpr (std::is_integral_v<ValueT> && sizeof(ValueT) <= 4)
+						return FindValueSSE2(First, Last, Value);
+					else
+#endif
+					{
+						for (; First < Last; First++)
+						{
+							if (*First == Value)
+								return First;
+						};
+						return nullptr;
+					};
+				};
+			};
+
+			// Contiguous run of slots inside the ring, for the zero-copy span APIs
+			template<typename ValueT>
+			struct RingBufferSpan
+			{
+				ValueT* Data = nullptr;
+				size_t Count = 0;
+			};
+
+			// Fixed prefix of a WriteTo snapshot, validated by ReadFrom before it
+			// touches the payload
+			struct RingBufferSnapshotHeader
+			{
+				// "HRZSNAP1", stamps a snapshot produced by WriteTo
+				static const size_t ExpectedMagic = 0x48525A534E415031;
+
+				size_t Magic = ExpectedMagic;
+				size_t Capacity = 0;
+				size_t ElementsInside = 0;
+			};
+
+#ifdef RING_BUFFER_ENABLE_STATS
+			// Snapshot of the opt-in per-ring counters (RING_BUFFER_ENABLE_STATS),
+			// returned by GetStats on every ring variant
+			struct RingBufferStats
+			{
+				size_t Pushes = 0;         // successful insertions
+				size_t Pops = 0;           // successful removals, consumed spans included
+				size_t FailedPushes = 0;   // insertions rejected on a full ring
+				size_t Wraps = 0;          // insertions that crossed the physical seam of the block
+				size_t HighWaterMark = 0;  // most elements seen inside at once
+				size_t Resizes = 0;        // capacity changes
+			};
+
+			// Relaxed-atomic counterpart for the threaded rings - producers and consumers
+			// bump their counters from their own threads, GetStats copies everything into
+			// a plain RingBufferStats snapshot
+			struct RingBufferAtomicStats
+			{
+				std::atomic<size_t> Pushes = 0;
+				std::atomic<size_t> Pops = 0;
+				std::atomic<size_t> FailedPushes = 0;
+				std::atomic<size_t> Wraps = 0;
+				std::atomic<size_t> HighWaterMark = 0;
+				std::atomic<size_t> Resizes = 0;
+
+				inline RingBufferStats Snapshot() const
+				{
+					RingBufferStats Result;
+					Result.Pushes = Pushes.load(std::memory_order_relaxed);
+					Result.Pops = Pops.load(std::memory_order_relaxed);
+					Result.FailedPushes = FailedPushes.load(std::memory_order_relaxed);
+					Result.Wraps = Wraps.load(std::memory_order_relaxed);
+					Result.HighWaterMark = HighWaterMark.load(std::memory_order_relaxed);
+					Result.Resizes = Resizes.load(std::memory_order_relaxed);
+					return Result;
+				};
+
+				inline void Reset()
+				{
+					Pushes.store(0, std::memory_order_relaxed);
+					Pops.store(0, std::memory_order_relaxed);
+					FailedPushes.store(0, std::memory_order_relaxed);
+					Wraps.store(0, std::memory_order_relaxed);
+					HighWaterMark.store(0, std::memory_order_relaxed);
+					Resizes.store(0, std::memory_order_relaxed);
+				};
+
+				inline void UpdateHighWaterMark(size_t Occupied)
+				{
+					size_t Seen = HighWaterMark.load(std::memory_order_relaxed);
+					while (Occupied > Seen && !HighWaterMark.compare_exchange_weak(Seen, Occupied, std::memory_order_relaxed)) {};
+				};
 			};
+#endif
 
-			// Ring buffer container with dynamic size. Could be used as static, if allocator is static, but resize operation will be limited 
+			// Ring buffer container with dynamic size. Could be used as static, if allocator is static, but resize operation will be limited
 			// by allocation memory size. Allocator Type must have following methods:
 			// Allocate(size_t bytes_to_allocate), Deallocate(void* MemoryToDeallocate)
 			// and be **Copy/Default Constructable**(to be able to construct/copy construct RingBuffer)
+			// An allocator may additionally provide Allocate(size_t bytes_to_allocate, size_t alignment) -
+			// when present (detected automatically) the ring requests at least alignof(ValueT),
+			// see utils::HugePageAllocator for an implementation
 			// Value Type must be Default constructable and movable
+			// With Pow2Capacity the capacity is constrained(rounded up) to a power of two and every
+			// index wrap becomes a mask instead of compare-and-branch, see RingBufferPow2 alias below
+			// With PaddedLayout the hot index fields are split onto separate cache lines (and the
+			// element block is requested cache-line aligned), so an externally-locked pipelined
+			// setup - one thread pushing while another polls sizes - stops ping-ponging the one
+			// line all fields share in the default layout. Costs up to three lines of padding
+			// per ring, nothing when off. See RingBufferPadded alias below
 #ifdef RING_BUFFER_USE_SIMPLE_ALLOCATOR
-			template<typename ValueT, typename AllocatorT = utils::TEST_SIMPLE_ALLOCATOR_FOR_RING_BUFFER>
+			template<typename ValueT, typename AllocatorT = utils::TEST_SIMPLE_ALLOCATOR_FOR_RING_BUFFER, bool Pow2Capacity = false, bool PaddedLayout = false>
 #else
-			template<typename ValueT, typename AllocatorT>
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity = false, bool PaddedLayout = false>
 #endif
 			class RingBuffer
 			{
@@ -412,13 +778,113 @@ namespace harz {
 				~RingBuffer();
 
 				size_t PushBack(ValueT value);
-				size_t EmplaceBack(ValueT&& value);
 				size_t PushFront(ValueT value);
-				size_t EmplaceFront(ValueT&& value);
+
+				// Construct the element directly inside its slot from the given constructor
+				// arguments, no temporary + swap involved
+				template<typename... ArgsT> size_t EmplaceBack(ArgsT&&... args);
+				template<typename... ArgsT> size_t EmplaceFront(ArgsT&&... args);
+
+				// Overwrite mode: same as PushBack/PushFront, but on a full ring the oldest
+				// element (the one the matching pop would hand out next) is destroyed to make
+				// room, so the push only fails if there is no storage at all
+				size_t PushBackOverwrite(ValueT value);
+				size_t PushFrontOverwrite(ValueT value);
+
+				// Bulk variants, equivalent to calling the element-at-a-time methods count times
+				// but without the per-call overhead. Each returns the number of elements actually
+				// pushed/popped, which is less than count if the ring runs out of space/elements.
+				// NOTE: back insertion walks the ring downwards in memory, so PushBackBulk/PopFrontBulk
+				// keep element order with a (vectorizable) slot-by-slot loop. The ascending direction
+				// is PushFrontBulk/PopBackBulk - for trivially copyable types that pair moves whole
+				// chunks with one or two detail::CopyMemory calls, so prefer it for streaming workloads
+				size_t PushBackBulk(const ValueT* src, size_t count);
+				size_t PopFrontBulk(ValueT* dst, size_t count);
+				size_t PushFrontBulk(const ValueT* src, size_t count);
+				size_t PopBackBulk(ValueT* dst, size_t count);
+
+				// Zero-copy reservation interface, e.g. for recv()'ing straight into the ring without
+				// a staging buffer. The front is the ascending-in-memory write end of this ring (see
+				// the bulk methods note above), so production reserves at the front and consumption
+				// releases from the back, matching the PushFrontBulk/PopBackBulk streaming direction.
+				// ReserveFront fills OutSpans (up to 2 contiguous runs) with writable slots but does not
+				// publish them - write your data, then call CommitFront with how many slots you filled.
+				// Don't push/pop/resize between Reserve and Commit, the spans go stale.
+				// For non trivially copyable types the caller is responsible for constructing values
+				// in the reserved slots before commit
+				size_t ReserveFront(size_t count, RingBufferSpan<ValueT> OutSpans[2]);
+				size_t CommitFront(size_t count);
+
+				// Symmetric read side: PeekBackSpans exposes up to 2 contiguous runs of the oldest
+				// elements (in order), ConsumeBack releases them without copying anything out
+				size_t PeekBackSpans(size_t count, RingBufferSpan<ValueT> OutSpans[2]);
+				size_t PeekBackSpans(size_t count, RingBufferSpan<const ValueT> OutSpans[2]) const;
+				size_t ConsumeBack(size_t count);
+
+				// Drain through a callback instead of popping element by element: walks the
+				// occupied range oldest-first over its (at most two) contiguous runs, calls
+				// fn(element) on each, destroys it in place and updates the indices once at
+				// the end - no per-element index bookkeeping and no moved-out temporaries,
+				// which is what a drain loop of thousands of elements per wakeup wants.
+				// ConsumeUpTo stops after count elements. Both return how many were consumed.
+				// The callback must not push/pop/resize this ring
+				template<typename FuncT>
+				size_t ConsumeAll(FuncT&& fn);
+				template<typename FuncT>
+				size_t ConsumeUpTo(size_t count, FuncT&& fn);
+
+				// Non-destructive begin->end traversal with software prefetch: fn(element)
+				// runs over the (at most two) contiguous runs while the element
+				// PrefetchDistance slots ahead - mapped across the wrap, where the hardware
+				// prefetcher loses the trail - is already being pulled toward L1. Worth it
+				// for big elements spanning several cache lines; for small ones a flat loop
+				// over GetContiguousSegments does just as well. The prefetch is a no-op off
+				// x86. The callback must not push/pop/resize this ring
+				template<typename FuncT>
+				void ForEach(FuncT&& fn, size_t PrefetchDistance = 8);
+				template<typename FuncT>
+				void ForEach(FuncT&& fn, size_t PrefetchDistance = 8) const;
+
+				// The whole occupied range as (at most two) contiguous runs in begin->end order,
+				// for flat loops over the elements - a vectorizable for over each run instead of
+				// stepping the indexed iterator slot by slot. Returns the number of runs filled
+				size_t GetContiguousSegments(RingBufferSpan<ValueT> OutSpans[2]);
+				size_t GetContiguousSegments(RingBufferSpan<const ValueT> OutSpans[2]) const;
+
+				// Snapshot the ring into a byte sink: one RingBufferSnapshotHeader write, then
+				// the occupied range as its at most two contiguous runs - three Write calls
+				// however big the ring, ready for writev-style gather I/O instead of an
+				// element-by-element iterator walk. Only for trivially copyable ValueT, the
+				// hook overload below handles everything else.
+				// Sink contract: bool Write(const void* Data, size_t Bytes)
+				template<typename SinkT>
+				bool WriteTo(SinkT& Sink) const;
+
+				// Element-wise variant for non-trivial types: the header is still one raw
+				// write, then WriteElement(Sink, element) runs per element in begin->end
+				// order and aborts the snapshot by returning false
+				template<typename SinkT, typename WriteElementFnT>
+				bool WriteTo(SinkT& Sink, WriteElementFnT&& WriteElement) const;
+
+				// Rebuild the ring from a WriteTo snapshot, replacing current contents and
+				// capacity. The occupied range is laid out from slot 0 upward - logically
+				// identical to the snapshotted ring, physical offsets are not preserved.
+				// Returns false (leaving the ring empty) on a short read or a header that
+				// doesn't look like ours.
+				// Source contract: bool Read(void* Data, size_t Bytes)
+				template<typename SourceT>
+				bool ReadFrom(SourceT& Source);
+
+				// Element-wise counterpart: ReadElement(Source, Slot) must construct the
+				// element into the raw Slot and return whether it managed to
+				template<typename SourceT, typename ReadElementFnT>
+				bool ReadFrom(SourceT& Source, ReadElementFnT&& ReadElement);
 
 				inline void Clear()
 				{
+					DestroyElements();
 					head = InvalidIndex();
+					tail = InvalidIndex();
 					elementsInside = 0;
 				}
 
@@ -440,11 +906,11 @@ namespace harz {
 				ValueT& Front() { return *PeekFront(); };
 				ValueT& Back() { return *PeekBack(); };
 
-				// Pop element from front
-				ValueT&& PopFront();
+				// Pop element from front. The stored element is moved out and destroyed
+				ValueT PopFront();
 
-				// Pop element from back
-				ValueT&& PopBack();
+				// Pop element from back. The stored element is moved out and destroyed
+				ValueT PopBack();
 
 				// Look at this index in the container, don't use a pointer after pushes/emplacements elements inside the ring
 				// NOTE: if index will be out of bounds(more that head index and less that tail index) or incorrect, return will be nullptr
@@ -454,9 +920,48 @@ namespace harz {
 				// NOTE: if index will be out of bounds(more that head index and less that tail index) or incorrect, return will be nullptr
 				const ValueT* LookAtIndex(size_t index) const;
 
+				// Replace the element at index: destroy it and construct the new one from the
+				// arguments directly in its slot - one in-place construct where a pop/push
+				// pair would pay two index recomputations and a move. Bounds-checked like
+				// LookAtIndex; returns the new element, or nullptr for an invalid index
+				template<typename... ArgsT>
+				ValueT* ReplaceAt(size_t index, ArgsT&&... args);
+
+				// Search the occupied range (in begin->end order) for the first element equal to
+				// value. Returns its slot index for use with LookAtIndex/operator[], or
+				// InvalidIndex if there is no match. Small integral types are searched with SSE2
+				// over the one or two contiguous segments, 16 bytes per step
+				size_t Find(const ValueT& value) const;
+
+				inline bool Contains(const ValueT& value) const { return Find(value) != InvalidIndex(); };
+
+				// Binary search over the occupied range for the first element whose key is not
+				// less than Key - the lower bound. Requires the ring to be ordered by
+				// KeyExtract(element) in begin->end order, which holds naturally for
+				// monotonic payloads like timestamped samples. Logical offsets are mapped to
+				// physical slots with the same tail arithmetic as GetNextIndexIter, so the
+				// wrap point costs nothing extra; O(log n) against Find's O(n).
+				// Returns end() if every element is before Key
+				template<typename KeyT, typename KeyExtractT>
+				IndexedIterator FindFirstNotBefore(const KeyT& Key, KeyExtractT&& KeyExtract);
+				template<typename KeyT, typename KeyExtractT>
+				ConstIndexedIterator FindFirstNotBefore(const KeyT& Key, KeyExtractT&& KeyExtract) const;
+
 				// Resize container. Could fail, if allocator couldn't allocate enough memory.
 				bool Resize(size_t capacity);
 
+				// Opt-in geometric auto-growth: when enabled, a push on a full ring doubles the
+				// capacity via Resize instead of failing, so push cost stays amortized constant.
+				// Note: growth relocates elements, outstanding pointers/spans/indices go stale
+				inline void SetAutoGrow(bool enable) { autoGrowEnabled = enable; };
+				inline bool IsAutoGrowEnabled() const { return autoGrowEnabled; };
+
+#ifdef RING_BUFFER_ENABLE_STATS
+				// Snapshot/reset of the traffic counters, only compiled in with RING_BUFFER_ENABLE_STATS
+				inline RingBufferStats GetStats() const { return stats; };
+				inline void ResetStats() { stats = {}; };
+#endif
+
 				// Get capacity;
 				inline size_t GetCapacity() const { return capacity; };
 
@@ -466,8 +971,8 @@ namespace harz {
 				// Get head index, in case of 0 elements, result will be InvalidIndex 
 				inline size_t GetHeadIndex() const { return head; };
 
-				// Get tail index, in case of 0 elements, result will be InvalidIndex 
-				size_t GetTailIndex() const;
+				// Get tail index, in case of 0 elements, result will be InvalidIndex
+				inline size_t GetTailIndex() const { return tail; };
 
 				// Stuff for convenient loop and useful operators
 				inline ValueT& operator[](size_t index) { RING_BUFFER_ASSERT(index < capacity); return *PointToValueAtIndex(index); }
@@ -514,13 +1019,21 @@ namespace harz {
 
 				inline bool IsIndexValid(size_t Index) const
 				{
-					if (Index >= capacity ||
-						elementsInside == 0 ||
-						Index == InvalidIndex() ||
-						Index < GetTailIndex() && Index > GetHeadIndex() ||
-						Index > GetTailIndex() && Index > GetHeadIndex() && GetTailIndex() <= GetHeadIndex())
-						return false;
-					return true;
+					// A slot is occupied iff its logical offset from the tail lands inside the
+					// element count - one subtract-and-wrap plus two compares, instead of the
+					// old five-way head/tail case split. This runs on every iterator step (and
+					// under RING_BUFFER_DEBUG on every dereference), so it has to predict well.
+					// An empty ring or InvalidIndex falls out as an InvalidIndex logical offset
+					return Index < capacity && GetLogicalIndex(Index) < elementsInside;
+				};
+
+				// Position of a slot inside the occupied range counted from begin (the tail),
+				// InvalidIndex for an empty ring. O(1), used for iterator distance
+				inline size_t GetLogicalIndex(size_t Index) const
+				{
+					if (!elementsInside || Index == InvalidIndex())
+						return InvalidIndex();
+					return Index >= tail ? Index - tail : Index + capacity - tail;
 				};
 
 			private:
@@ -531,18 +1044,16 @@ namespace harz {
 				inline size_t GetEndIndex() const { return GetHeadIndex(); };
 				inline size_t GetNextIndexIter(size_t index) const
 				{
-					if (index == InvalidIndex())
+					// The head is the last occupied slot, one step past it is always the end.
+					// Checked explicitly - on a full ring every slot is valid, so the
+					// IsIndexValid check below could never stop the walk on its own
+					if (index == InvalidIndex() || index == GetHeadIndex())
 					{
 						return InvalidIndex();
 					}
 
 					if (GetTailIndex() > GetHeadIndex())
-					{
-						if (index == GetCapacity() - 1)
-							index = 0;
-						else
-							index++;
-					}
+						index = IncrementIndexWrapped(index);
 					else
 						index++;
 
@@ -554,76 +1065,30 @@ namespace harz {
 
 				inline size_t GetNextIndexIter(size_t index, size_t offset) const
 				{
-					if (!offset)
-						return index;
-
-					if (index == InvalidIndex())
-					{
-						return InvalidIndex();
-					}
-
-					if (GetTailIndex() > GetHeadIndex())
-					{
-						if (index == GetCapacity() - 1)
-						{
-							if (offset - 1 > GetHeadIndex())
-								return InvalidIndex();
-
-							index = offset - 1; // 0 or 0+offset-1 items, as 0 is first item
-						}
-						else
-						{
-							if (index < GetCapacity() - 1)
-							{
-								size_t TailBackOffset = GetCapacity() - 1 - index;
-								if (offset > TailBackOffset)
-								{
-									size_t BackOffset = offset - TailBackOffset;
-									if (BackOffset - 1 > GetHeadIndex())
-										return InvalidIndex();
-									else
-										index = BackOffset - 1;
-								}
-								else
-									index += offset;
-							}
-							else
-							{
-								if (offset > GetHeadIndex())
-									return InvalidIndex();
-
-								index += offset;
-							}
-						};
-					}
-					else
-					{
-						if (GetTailIndex() + offset > GetHeadIndex())
-							return InvalidIndex();
+					// Map to the logical position, step there and map back - O(1) for any
+					// offset and immune to the wrap point
+					const size_t Logical = GetLogicalIndex(index);
+					if (Logical == InvalidIndex() || Logical + offset >= elementsInside)
+						return offset ? InvalidIndex() : index;
 
-						index += offset;
-					}
-
-					if (!IsIndexValid(index))
-						return InvalidIndex();
+					size_t SteppedIndex = GetTailIndex() + Logical + offset;
+					if (SteppedIndex >= capacity)
+						SteppedIndex -= capacity;
 
-					return index;
+					return SteppedIndex;
 				};
 
 				inline size_t GetPreviousIndexIter(size_t index) const
 				{
-					if (index == InvalidIndex())
+					// Same reasoning as GetNextIndexIter - the tail is the first occupied
+					// slot, one step before it is always outside the range
+					if (index == InvalidIndex() || index == GetTailIndex())
 					{
 						return InvalidIndex();
 					}
 
 					if (GetTailIndex() > GetHeadIndex())
-					{
-						if (index == 0)
-							index = GetCapacity() - 1;
-						else
-							index--;
-					}
+						index = DecrementIndexWrapped(index);
 					else
 						index--;
 
@@ -635,83 +1100,158 @@ namespace harz {
 
 				inline size_t GetPreviousIndexIter(size_t index, size_t offset) const
 				{
-					if (!offset)
-						return index;
+					const size_t Logical = GetLogicalIndex(index);
+					if (Logical == InvalidIndex() || offset > Logical)
+						return offset ? InvalidIndex() : index;
 
-					if (index == InvalidIndex())
-					{
-						return InvalidIndex();
-					}
+					size_t SteppedIndex = GetTailIndex() + Logical - offset;
+					if (SteppedIndex >= capacity)
+						SteppedIndex -= capacity;
 
-					if (GetTailIndex() > GetHeadIndex())
-					{
-						if (index >= 0 && index <= GetHeadIndex())
-						{
-							size_t HeadBackOffset = index;
-							if (offset == HeadBackOffset + 1)
-								index = 0;
-							else
-							{
-								if (offset > HeadBackOffset + 1)
-								{
-									if (GetCapacity() - 1 - GetTailIndex() < offset - HeadBackOffset + 1)
-										return InvalidIndex();
-									else
-										index = GetCapacity() - (offset - HeadBackOffset + 1);
-								}
-								else
-								{
-									index -= offset;
-								}
-							}
-						}
-						else
-						{
-							if (offset > index - GetTailIndex())
-								return InvalidIndex();
-							else
-							{
-								index = index - offset;
-							}
-						}
-					}
-					else
-					{
-						if (index < offset - 1)
-							return InvalidIndex();
-						index -= offset;
-					}
+					return SteppedIndex;
+				};
 
-					if (!IsIndexValid(index))
-						return InvalidIndex();
 
-					return index;
+				// Advance/rewind one slot with wraparound. In Pow2Capacity mode this is a single
+				// mask operation instead of compare-and-branch, which avoids a mispredict on every wrap
+				inline size_t IncrementIndexWrapped(size_t index) const
+				{
+					if constexpr (Pow2Capacity)
+						return (index + 1) & (capacity - 1);
+					else
+						return index == capacity - 1 ? 0 : index + 1;
 				};
 
+				inline size_t DecrementIndexWrapped(size_t index) const
+				{
+					if constexpr (Pow2Capacity)
+						return (index - 1) & (capacity - 1);
+					else
+						return index == 0 ? capacity - 1 : index - 1;
+				};
 
 			private:
 
 				ValueT* PointToValueAtIndex(size_t index);
 				const ValueT* PointToValueAtIndex(size_t index) const;
+
+				// Make sure at least count slots are free before a push. With auto-growth off
+				// this just reports whether the room is there; with it on, the capacity is
+				// doubled (repeatedly for bulk pushes) until the request fits
+				inline bool EnsureRoomForPush(size_t count = 1)
+				{
+					if (MemoryBlock && capacity - elementsInside >= count)
+						return true;
+
+					if (!autoGrowEnabled)
+						return false;
+
+					size_t NewCapacity = capacity ? capacity : AutoGrowInitialCapacity;
+					while (NewCapacity - elementsInside < count)
+						NewCapacity *= 2;
+
+					return Resize(NewCapacity);
+				};
+
+				// Run destructors of all live elements, slots become raw storage again
+				inline void DestroyElements()
+				{
+					if constexpr (!std::is_trivially_destructible_v<ValueT>)
+					{
+						for (auto& element : *this)
+						{
+							element.~ValueT();
+						};
+					};
+				};
+				// Route allocations through the extended Allocate(size, alignment) contract
+				// when the allocator provides it, so a ValueT with a big alignas (cache line,
+				// SIMD vector) actually lands on its boundary instead of wherever malloc put it
+				inline void* AllocateMemoryBlock(size_t BytesToAllocate)
+				{
+					if constexpr (detail::THasAlignedAllocate<AllocatorT>::value)
+					{
+						constexpr size_t BaseAlignment = alignof(ValueT) > alignof(void*) ? alignof(ValueT) : alignof(void*);
+						// PaddedLayout also wants the element block on its own line boundary,
+						// so the array never shares a line with a neighbouring allocation
+						constexpr size_t Alignment = PaddedLayout && BaseAlignment < RING_BUFFER_CACHE_LINE_SIZE
+							? RING_BUFFER_CACHE_LINE_SIZE : BaseAlignment;
+						return m_InternalAllocator.Allocate(BytesToAllocate, Alignment);
+					}
+					else
+					{
+						return m_InternalAllocator.Allocate(BytesToAllocate);
+					};
+				};
+
+				// Validate a snapshot header and ready the block for its payload;
+				// the ring is empty afterwards either way
+				bool PrepareForSnapshotPayload(const RingBufferSnapshotHeader& Header);
+
 				inline ValueT** GetData() { return MemoryBlock; }
 				inline const ValueT** GetData() const { return (const ValueT**)MemoryBlock; }
 				inline size_t GetNextHeadIndex() const;
 				inline size_t GetNextTailIndex() const;
+
+#ifdef RING_BUFFER_ENABLE_STATS
+				// Bumps the push-side counters; WrappedSeam marks an insertion that
+				// crossed the physical end of the memory block
+				inline void StatsOnPush(size_t count, bool WrappedSeam)
+				{
+					stats.Pushes += count;
+					if (WrappedSeam)
+						stats.Wraps++;
+					if (elementsInside > stats.HighWaterMark)
+						stats.HighWaterMark = elementsInside;
+				};
+#endif
+
+				// Cold, read-mostly after construction
 				AllocatorT m_InternalAllocator = AllocatorT{};
-				ValueT** MemoryBlock;
+				ValueT** MemoryBlock = nullptr;
 				size_t capacity = 0;
+				bool autoGrowEnabled = false;
+				// Both ends are stored explicitly, so the hot accessors are a single load.
+				// Every mutator has to keep head/tail/elementsInside consistent.
+				// With PaddedLayout the pads below push the front-written head, the
+				// back-written tail/count and the cold fields onto separate cache lines;
+				// in the default layout they are empty types and vanish
+				RING_BUFFER_NO_UNIQUE_ADDRESS detail::TCacheLinePad<PaddedLayout, 0> PadAfterColdFields;
 				size_t head = InvalidIndex();
+				RING_BUFFER_NO_UNIQUE_ADDRESS detail::TCacheLinePad<PaddedLayout, 1> PadAfterHead;
+				size_t tail = InvalidIndex();
 				size_t elementsInside = 0;
+				RING_BUFFER_NO_UNIQUE_ADDRESS detail::TCacheLinePad<PaddedLayout, 2> PadAfterIndices;
+				static constexpr size_t AutoGrowInitialCapacity = 8;
+#ifdef RING_BUFFER_ENABLE_STATS
+				RingBufferStats stats = {};
+#endif
 			};
 
+			// Alias for the power-of-two capacity mode, for tight loops which wrap often
+#ifdef RING_BUFFER_USE_SIMPLE_ALLOCATOR
+			template<typename ValueT, typename AllocatorT = utils::TEST_SIMPLE_ALLOCATOR_FOR_RING_BUFFER>
+#else
+			template<typename ValueT, typename AllocatorT>
+#endif
+			using RingBufferPow2 = RingBuffer<ValueT, AllocatorT, true>;
+
+			// Alias for the anti-false-sharing layout, see the PaddedLayout notes above
+#ifdef RING_BUFFER_USE_SIMPLE_ALLOCATOR
+			template<typename ValueT, typename AllocatorT = utils::TEST_SIMPLE_ALLOCATOR_FOR_RING_BUFFER>
+#else
 			template<typename ValueT, typename AllocatorT>
-			RingBuffer<ValueT, AllocatorT>::RingBuffer()
+#endif
+			using RingBufferPadded = RingBuffer<ValueT, AllocatorT, false, true>;
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::RingBuffer()
 			{
 				head = InvalidIndex();
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			RingBuffer<ValueT, AllocatorT>::RingBuffer(const RingBuffer& Other)
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::RingBuffer(const RingBuffer& Other)
 			{
 				Resize(Other.capacity);
 				if (Other.elementsInside > 0)
@@ -723,25 +1263,28 @@ namespace harz {
 				};
 			}
 
-			template<typename ValueT, typename AllocatorT>
-			RingBuffer<ValueT, AllocatorT>::RingBuffer(const RingBuffer&& Other)
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::RingBuffer(const RingBuffer&& Other)
 			{
 				MemoryBlock = Other.MemoryBlock;
 				head = Other.head;
+				tail = Other.tail;
 				elementsInside = Other.elementsInside;
 				capacity = Other.capacity;
 				m_InternalAllocator = Other.m_InternalAllocator;
 
 				Other.MemoryBlock = nullptr;
 				Other.head = InvalidIndex();
+				Other.tail = InvalidIndex();
 				Other.elementsInside = 0;
 				Other.capacity = 0;
 				Other.m_InternalAllocator = {};
 			}
 
-			template<typename ValueT, typename AllocatorT>
-			inline RingBuffer<ValueT, AllocatorT>& RingBuffer<ValueT, AllocatorT>::operator=(const RingBuffer& Other)
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			inline RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>& RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::operator=(const RingBuffer& Other)
 			{
+				Clear();
 				Resize(Other.capacity);
 				if (Other.elementsInside > 0)
 				{
@@ -753,12 +1296,15 @@ namespace harz {
 				return *this;
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			RingBuffer<ValueT, AllocatorT>::RingBuffer(size_t capacity)
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::RingBuffer(size_t capacity)
 			{
+				if constexpr (Pow2Capacity)
+					capacity = detail::RoundUpToPowerOfTwo(capacity);
+
 				if (capacity > 0 && capacity != InvalidIndex())
 				{
-					MemoryBlock = (ValueT**)m_InternalAllocator.Allocate(capacity * (sizeof(ValueT)));
+					MemoryBlock = (ValueT**)AllocateMemoryBlock(capacity * (sizeof(ValueT)));
 					if (MemoryBlock)
 					{
 						this->capacity = capacity;
@@ -766,22 +1312,19 @@ namespace harz {
 					}
 				};
 			};
-			template<typename ValueT, typename AllocatorT>
-			RingBuffer<ValueT, AllocatorT>::~RingBuffer()
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::~RingBuffer()
 			{
 				if (MemoryBlock)
 				{
-					for (auto& element : *this)
-					{
-						element.~ValueT();
-					}
+					DestroyElements();
 					m_InternalAllocator.Deallocate(MemoryBlock);
 				}
 			};
-			template<typename ValueT, typename AllocatorT>
-			size_t RingBuffer<ValueT, AllocatorT>::PushBack(ValueT value)
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PushBack(ValueT value)
 			{
-				if (MemoryBlock && capacity > elementsInside)
+				if (EnsureRoomForPush())
 				{
 					size_t IndexForPushedElement = 0;
 
@@ -792,20 +1335,25 @@ namespace harz {
 
 					ValueT* ItemAtIndex = PointToValueAtIndex(IndexForPushedElement);
 
-					*ItemAtIndex = value;
+					// Slot is raw storage, construct the element in place
+					new (ItemAtIndex) ValueT(std::move(value));
 					elementsInside++;
+					tail = IndexForPushedElement;
 					if (head == InvalidIndex())
 					{
 						head = IndexForPushedElement;
 					};
+					RING_BUFFER_STAT(StatsOnPush(1, elementsInside > 1 && IndexForPushedElement == capacity - 1))
 					return IndexForPushedElement;
 				}
+				RING_BUFFER_STAT(stats.FailedPushes++)
 				return InvalidIndex();
 			};
-			template<typename ValueT, typename AllocatorT>
-			size_t RingBuffer<ValueT, AllocatorT>::EmplaceBack(ValueT&& value)
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			template<typename... ArgsT>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::EmplaceBack(ArgsT&&... args)
 			{
-				if (MemoryBlock && capacity > elementsInside)
+				if (EnsureRoomForPush())
 				{
 					size_t IndexForEmplacedElement = 0;
 
@@ -814,8 +1362,9 @@ namespace harz {
 						IndexForEmplacedElement = GetNextTailIndex();
 					};
 
-					std::swap(*PointToValueAtIndex(IndexForEmplacedElement), value);
+					new (PointToValueAtIndex(IndexForEmplacedElement)) ValueT(std::forward<ArgsT>(args)...);
 					elementsInside++;
+					tail = IndexForEmplacedElement;
 
 					// If it's first push/emplace of element, set head by this index
 					if (head == InvalidIndex())
@@ -823,15 +1372,17 @@ namespace harz {
 						head = IndexForEmplacedElement;
 					}
 
+					RING_BUFFER_STAT(StatsOnPush(1, elementsInside > 1 && IndexForEmplacedElement == capacity - 1))
 					return IndexForEmplacedElement;
 				};
+				RING_BUFFER_STAT(stats.FailedPushes++)
 				return InvalidIndex();
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			size_t RingBuffer<ValueT, AllocatorT>::PushFront(ValueT value)
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PushFront(ValueT value)
 			{
-				if (MemoryBlock && capacity > elementsInside)
+				if (EnsureRoomForPush())
 				{
 					size_t IndexForPushedElement = 0;
 
@@ -840,18 +1391,25 @@ namespace harz {
 						IndexForPushedElement = GetNextHeadIndex();
 					};
 
-					*PointToValueAtIndex(IndexForPushedElement) = value;
+					new (PointToValueAtIndex(IndexForPushedElement)) ValueT(std::move(value));
 					head = IndexForPushedElement;
 					elementsInside++;
+					if (tail == InvalidIndex())
+					{
+						tail = IndexForPushedElement;
+					};
+					RING_BUFFER_STAT(StatsOnPush(1, elementsInside > 1 && IndexForPushedElement == 0))
 					return IndexForPushedElement;
 				};
+				RING_BUFFER_STAT(stats.FailedPushes++)
 				return InvalidIndex();
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			size_t RingBuffer<ValueT, AllocatorT>::EmplaceFront(ValueT&& value)
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			template<typename... ArgsT>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::EmplaceFront(ArgsT&&... args)
 			{
-				if (MemoryBlock && capacity > elementsInside)
+				if (EnsureRoomForPush())
 				{
 					size_t IndexForEmplacedElement = 0;
 
@@ -860,16 +1418,585 @@ namespace harz {
 						IndexForEmplacedElement = GetNextHeadIndex();
 					};
 
-					std::swap(*PointToValueAtIndex(IndexForEmplacedElement), value);
+					new (PointToValueAtIndex(IndexForEmplacedElement)) ValueT(std::forward<ArgsT>(args)...);
 					head = IndexForEmplacedElement;
 					elementsInside++;
+					if (tail == InvalidIndex())
+					{
+						tail = IndexForEmplacedElement;
+					};
+					RING_BUFFER_STAT(StatsOnPush(1, elementsInside > 1 && IndexForEmplacedElement == 0))
 					return IndexForEmplacedElement;
 				};
+				RING_BUFFER_STAT(stats.FailedPushes++)
 				return InvalidIndex();
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			RingBuffer<ValueT, AllocatorT>::IndexedIterator RingBuffer<ValueT, AllocatorT>::PeekFront()
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PushBackOverwrite(ValueT value)
+			{
+				if (MemoryBlock && elementsInside == capacity)
+				{
+					// Evict the front element - for back insertion it is the oldest one.
+					// Destroy in place instead of PopFront, nothing has to be moved out
+					PointToValueAtIndex(head)->~ValueT();
+					elementsInside--;
+					RING_BUFFER_STAT(stats.Pops++)
+					if (elementsInside)
+						head = DecrementIndexWrapped(head);
+					else
+					{
+						head = InvalidIndex();
+						tail = InvalidIndex();
+					};
+				};
+				return PushBack(std::move(value));
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PushFrontOverwrite(ValueT value)
+			{
+				if (MemoryBlock && elementsInside == capacity)
+				{
+					// Evict the back element - for front insertion it is the oldest one
+					PointToValueAtIndex(tail)->~ValueT();
+					elementsInside--;
+					RING_BUFFER_STAT(stats.Pops++)
+					if (elementsInside)
+						tail = IncrementIndexWrapped(tail);
+					else
+					{
+						head = InvalidIndex();
+						tail = InvalidIndex();
+					};
+				};
+				return PushFront(std::move(value));
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PushBackBulk(const ValueT* src, size_t count)
+			{
+				if (!src || !count)
+					return 0;
+
+				EnsureRoomForPush(count);
+
+				if (!MemoryBlock)
+					return 0;
+
+				const size_t FreeSlots = capacity - elementsInside;
+				const size_t ToPush = count < FreeSlots ? count : FreeSlots;
+				if (!ToPush)
+					return 0;
+
+				size_t Index = 0;
+				if (GetTailIndex() != InvalidIndex())
+					Index = GetNextTailIndex();
+
+				if (head == InvalidIndex())
+					head = Index;
+
+				// Back insertion walks downwards, slot-by-slot to keep src order
+				RING_BUFFER_STAT(const bool WrappedSeam = ToPush > Index + 1)
+				for (size_t pushed = 0; pushed < ToPush; pushed++)
+				{
+					new (PointToValueAtIndex(Index)) ValueT(src[pushed]);
+					tail = Index;
+					Index = DecrementIndexWrapped(Index);
+				};
+
+				elementsInside += ToPush;
+				RING_BUFFER_STAT(StatsOnPush(ToPush, WrappedSeam))
+				return ToPush;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PopFrontBulk(ValueT* dst, size_t count)
+			{
+				if (!MemoryBlock || !dst || !count || !elementsInside)
+					return 0;
+
+				const size_t ToPop = count < elementsInside ? count : elementsInside;
+
+				size_t Index = head;
+				for (size_t popped = 0; popped < ToPop; popped++)
+				{
+					ValueT* Item = PointToValueAtIndex(Index);
+					dst[popped] = std::move(*Item);
+					Item->~ValueT();
+					Index = DecrementIndexWrapped(Index);
+				};
+
+				elementsInside -= ToPop;
+				RING_BUFFER_STAT(stats.Pops += ToPop)
+				if (elementsInside)
+					head = Index;
+				else
+				{
+					head = InvalidIndex();
+					tail = InvalidIndex();
+				};
+
+				return ToPop;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PushFrontBulk(const ValueT* src, size_t count)
+			{
+				if (!src || !count)
+					return 0;
+
+				EnsureRoomForPush(count);
+
+				if (!MemoryBlock)
+					return 0;
+
+				const size_t FreeSlots = capacity - elementsInside;
+				const size_t ToPush = count < FreeSlots ? count : FreeSlots;
+				if (!ToPush)
+					return 0;
+
+				size_t Index = 0;
+				if (head != InvalidIndex())
+					Index = GetNextHeadIndex();
+
+				if (tail == InvalidIndex())
+					tail = Index;
+
+				RING_BUFFER_STAT(const bool WrappedSeam = Index + ToPush > capacity)
+
+				if constexpr (std::is_trivially_copyable_v<ValueT>)
+				{
+					// Front insertion walks upwards, so the chunk maps onto one or two contiguous spans
+					const size_t FirstSpan = ToPush < capacity - Index ? ToPush : capacity - Index;
+					detail::CopyMemory((void*)src, PointToValueAtIndex(Index), FirstSpan * sizeof(ValueT));
+					if (ToPush > FirstSpan)
+						detail::CopyMemory((void*)(src + FirstSpan), PointToValueAtIndex(0), (ToPush - FirstSpan) * sizeof(ValueT));
+					head = Index + ToPush - 1 < capacity ? Index + ToPush - 1 : Index + ToPush - 1 - capacity;
+				}
+				else
+				{
+					for (size_t pushed = 0; pushed < ToPush; pushed++)
+					{
+						new (PointToValueAtIndex(Index)) ValueT(src[pushed]);
+						head = Index;
+						Index = IncrementIndexWrapped(Index);
+					};
+				};
+
+				elementsInside += ToPush;
+				RING_BUFFER_STAT(StatsOnPush(ToPush, WrappedSeam))
+				return ToPush;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PopBackBulk(ValueT* dst, size_t count)
+			{
+				if (!MemoryBlock || !dst || !count || !elementsInside)
+					return 0;
+
+				const size_t ToPop = count < elementsInside ? count : elementsInside;
+				size_t Index = GetTailIndex();
+
+				if constexpr (std::is_trivially_copyable_v<ValueT>)
+				{
+					// Back consumption walks upwards from the tail, again one or two contiguous spans
+					const size_t FirstSpan = ToPop < capacity - Index ? ToPop : capacity - Index;
+					detail::CopyMemory(PointToValueAtIndex(Index), dst, FirstSpan * sizeof(ValueT));
+					if (ToPop > FirstSpan)
+						detail::CopyMemory(PointToValueAtIndex(0), dst + FirstSpan, (ToPop - FirstSpan) * sizeof(ValueT));
+					Index = Index + ToPop < capacity ? Index + ToPop : Index + ToPop - capacity;
+				}
+				else
+				{
+					for (size_t popped = 0; popped < ToPop; popped++)
+					{
+						ValueT* Item = PointToValueAtIndex(Index);
+						dst[popped] = std::move(*Item);
+						Item->~ValueT();
+						Index = IncrementIndexWrapped(Index);
+					};
+				};
+
+				elementsInside -= ToPop;
+				RING_BUFFER_STAT(stats.Pops += ToPop)
+				if (elementsInside)
+					tail = Index;
+				else
+				{
+					head = InvalidIndex();
+					tail = InvalidIndex();
+				};
+
+				return ToPop;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::ReserveFront(size_t count, RingBufferSpan<ValueT> OutSpans[2])
+			{
+				OutSpans[0] = {};
+				OutSpans[1] = {};
+
+				if (!MemoryBlock || !count)
+					return 0;
+
+				const size_t FreeSlots = capacity - elementsInside;
+				const size_t ToReserve = count < FreeSlots ? count : FreeSlots;
+				if (!ToReserve)
+					return 0;
+
+				size_t Start = 0;
+				if (head != InvalidIndex())
+					Start = GetNextHeadIndex();
+
+				const size_t FirstSpan = ToReserve < capacity - Start ? ToReserve : capacity - Start;
+				OutSpans[0] = { PointToValueAtIndex(Start), FirstSpan };
+				if (ToReserve > FirstSpan)
+					OutSpans[1] = { PointToValueAtIndex(0), ToReserve - FirstSpan };
+
+				return ToReserve;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::CommitFront(size_t count)
+			{
+				if (!MemoryBlock || !count)
+					return 0;
+
+				const size_t FreeSlots = capacity - elementsInside;
+				const size_t ToCommit = count < FreeSlots ? count : FreeSlots;
+				RING_BUFFER_ASSERT(ToCommit == count);
+				if (!ToCommit)
+					return 0;
+
+				size_t Start = 0;
+				if (head != InvalidIndex())
+					Start = GetNextHeadIndex();
+
+				if (tail == InvalidIndex())
+					tail = Start;
+
+				head = Start + ToCommit - 1 < capacity ? Start + ToCommit - 1 : Start + ToCommit - 1 - capacity;
+				elementsInside += ToCommit;
+				RING_BUFFER_STAT(StatsOnPush(ToCommit, Start + ToCommit > capacity))
+				return ToCommit;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PeekBackSpans(size_t count, RingBufferSpan<ValueT> OutSpans[2])
+			{
+				OutSpans[0] = {};
+				OutSpans[1] = {};
+
+				if (!MemoryBlock || !count || !elementsInside)
+					return 0;
+
+				const size_t ToPeek = count < elementsInside ? count : elementsInside;
+				const size_t Start = tail;
+
+				const size_t FirstSpan = ToPeek < capacity - Start ? ToPeek : capacity - Start;
+				OutSpans[0] = { PointToValueAtIndex(Start), FirstSpan };
+				if (ToPeek > FirstSpan)
+					OutSpans[1] = { PointToValueAtIndex(0), ToPeek - FirstSpan };
+
+				return ToPeek;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PeekBackSpans(size_t count, RingBufferSpan<const ValueT> OutSpans[2]) const
+			{
+				OutSpans[0] = {};
+				OutSpans[1] = {};
+
+				if (!MemoryBlock || !count || !elementsInside)
+					return 0;
+
+				const size_t ToPeek = count < elementsInside ? count : elementsInside;
+				const size_t Start = tail;
+
+				const size_t FirstSpan = ToPeek < capacity - Start ? ToPeek : capacity - Start;
+				OutSpans[0] = { PointToValueAtIndex(Start), FirstSpan };
+				if (ToPeek > FirstSpan)
+					OutSpans[1] = { PointToValueAtIndex(0), ToPeek - FirstSpan };
+
+				return ToPeek;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::GetContiguousSegments(RingBufferSpan<ValueT> OutSpans[2])
+			{
+				const size_t Peeked = PeekBackSpans(elementsInside, OutSpans);
+				return !Peeked ? 0 : OutSpans[1].Count ? 2 : 1;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::GetContiguousSegments(RingBufferSpan<const ValueT> OutSpans[2]) const
+			{
+				const size_t Peeked = PeekBackSpans(elementsInside, OutSpans);
+				return !Peeked ? 0 : OutSpans[1].Count ? 2 : 1;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			template<typename SinkT>
+			bool RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::WriteTo(SinkT& Sink) const
+			{
+				static_assert(std::is_trivially_copyable_v<ValueT>,
+					"raw-span snapshots need a trivially copyable ValueT, use the WriteElement overload");
+
+				RingBufferSnapshotHeader Header;
+				Header.Capacity = capacity;
+				Header.ElementsInside = elementsInside;
+				if (!Sink.Write(&Header, sizeof(Header)))
+					return false;
+
+				RingBufferSpan<const ValueT> Spans[2];
+				const size_t SpansCount = GetContiguousSegments(Spans);
+				for (size_t Span = 0; Span < SpansCount; Span++)
+				{
+					if (!Sink.Write(Spans[Span].Data, Spans[Span].Count * sizeof(ValueT)))
+						return false;
+				};
+				return true;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			template<typename SinkT, typename WriteElementFnT>
+			bool RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::WriteTo(SinkT& Sink, WriteElementFnT&& WriteElement) const
+			{
+				RingBufferSnapshotHeader Header;
+				Header.Capacity = capacity;
+				Header.ElementsInside = elementsInside;
+				if (!Sink.Write(&Header, sizeof(Header)))
+					return false;
+
+				RingBufferSpan<const ValueT> Spans[2];
+				const size_t SpansCount = GetContiguousSegments(Spans);
+				for (size_t Span = 0; Span < SpansCount; Span++)
+				{
+					for (size_t element = 0; element < Spans[Span].Count; element++)
+					{
+						if (!WriteElement(Sink, Spans[Span].Data[element]))
+							return false;
+					};
+				};
+				return true;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			bool RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PrepareForSnapshotPayload(const RingBufferSnapshotHeader& Header)
+			{
+				Clear();
+
+				if (Header.Magic != RingBufferSnapshotHeader::ExpectedMagic ||
+					Header.Capacity == 0 ||
+					Header.Capacity == InvalidIndex() ||
+					Header.ElementsInside > Header.Capacity ||
+					(Pow2Capacity && (Header.Capacity & (Header.Capacity - 1)) != 0))
+					return false;
+
+				if (capacity != Header.Capacity)
+				{
+					if (MemoryBlock)
+						m_InternalAllocator.Deallocate(MemoryBlock);
+					MemoryBlock = (ValueT**)AllocateMemoryBlock(Header.Capacity * sizeof(ValueT));
+					capacity = MemoryBlock ? Header.Capacity : 0;
+				};
+				return MemoryBlock != nullptr;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			template<typename SourceT>
+			bool RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::ReadFrom(SourceT& Source)
+			{
+				static_assert(std::is_trivially_copyable_v<ValueT>,
+					"raw-span snapshots need a trivially copyable ValueT, use the ReadElement overload");
+
+				RingBufferSnapshotHeader Header{};
+				if (!Source.Read(&Header, sizeof(Header)) || !PrepareForSnapshotPayload(Header))
+				{
+					Clear();
+					return false;
+				};
+
+				if (Header.ElementsInside)
+				{
+					if (!Source.Read(PointToValueAtIndex(0), Header.ElementsInside * sizeof(ValueT)))
+						return false;
+					tail = 0;
+					head = Header.ElementsInside - 1;
+					elementsInside = Header.ElementsInside;
+				};
+				return true;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			template<typename SourceT, typename ReadElementFnT>
+			bool RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::ReadFrom(SourceT& Source, ReadElementFnT&& ReadElement)
+			{
+				RingBufferSnapshotHeader Header{};
+				if (!Source.Read(&Header, sizeof(Header)) || !PrepareForSnapshotPayload(Header))
+				{
+					Clear();
+					return false;
+				};
+
+				for (size_t element = 0; element < Header.ElementsInside; element++)
+				{
+					if (!ReadElement(Source, PointToValueAtIndex(element)))
+					{
+						// Roll back what got constructed, the ring stays empty
+						for (size_t Constructed = 0; Constructed < element; Constructed++)
+							PointToValueAtIndex(Constructed)->~ValueT();
+						return false;
+					};
+				};
+
+				if (Header.ElementsInside)
+				{
+					tail = 0;
+					head = Header.ElementsInside - 1;
+					elementsInside = Header.ElementsInside;
+				};
+				return true;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::ConsumeBack(size_t count)
+			{
+				if (!MemoryBlock || !count || !elementsInside)
+					return 0;
+
+				const size_t ToConsume = count < elementsInside ? count : elementsInside;
+
+				if constexpr (!std::is_trivially_destructible_v<ValueT>)
+				{
+					size_t Index = tail;
+					for (size_t consumed = 0; consumed < ToConsume; consumed++)
+					{
+						PointToValueAtIndex(Index)->~ValueT();
+						Index = IncrementIndexWrapped(Index);
+					};
+				};
+
+				elementsInside -= ToConsume;
+				RING_BUFFER_STAT(stats.Pops += ToConsume)
+				if (elementsInside)
+					tail = tail + ToConsume < capacity ? tail + ToConsume : tail + ToConsume - capacity;
+				else
+				{
+					head = InvalidIndex();
+					tail = InvalidIndex();
+				};
+
+				return ToConsume;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			template<typename FuncT>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::ConsumeAll(FuncT&& fn)
+			{
+				return ConsumeUpTo(elementsInside, std::forward<FuncT>(fn));
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			template<typename FuncT>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::ConsumeUpTo(size_t count, FuncT&& fn)
+			{
+				if (!MemoryBlock || !count || !elementsInside)
+					return 0;
+
+				const size_t ToConsume = count < elementsInside ? count : elementsInside;
+
+				// Oldest-first is the tail and upwards - one or two flat runs, same split
+				// as PeekBackSpans, so the compiler sees two plain pointer loops
+				const size_t FirstSpan = ToConsume < capacity - tail ? ToConsume : capacity - tail;
+				ValueT* Item = PointToValueAtIndex(tail);
+				for (size_t consumed = 0; consumed < FirstSpan; consumed++, Item++)
+				{
+					fn(*Item);
+					Item->~ValueT();
+				};
+				Item = PointToValueAtIndex(0);
+				for (size_t consumed = FirstSpan; consumed < ToConsume; consumed++, Item++)
+				{
+					fn(*Item);
+					Item->~ValueT();
+				};
+
+				elementsInside -= ToConsume;
+				RING_BUFFER_STAT(stats.Pops += ToConsume)
+				if (elementsInside)
+					tail = tail + ToConsume < capacity ? tail + ToConsume : tail + ToConsume - capacity;
+				else
+				{
+					head = InvalidIndex();
+					tail = InvalidIndex();
+				};
+
+				return ToConsume;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			template<typename FuncT>
+			void RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::ForEach(FuncT&& fn, size_t PrefetchDistance)
+			{
+				if (!MemoryBlock || !elementsInside)
+					return;
+
+				// Same oldest-first split as ConsumeUpTo. The lookahead index is logical,
+				// so it steps off the end of the first run straight onto the start of the
+				// second - the prefetch stream never stalls at the wrap point
+				const size_t FirstSpan = elementsInside < capacity - tail ? elementsInside : capacity - tail;
+				ValueT* First = PointToValueAtIndex(tail);
+				ValueT* Second = PointToValueAtIndex(0);
+				for (size_t Index = 0; Index < FirstSpan; Index++)
+				{
+					const size_t Ahead = Index + PrefetchDistance;
+					if (Ahead < FirstSpan)
+						detail::PrefetchForRead(First + Ahead);
+					else if (Ahead < elementsInside)
+						detail::PrefetchForRead(Second + (Ahead - FirstSpan));
+					fn(First[Index]);
+				};
+				for (size_t Index = FirstSpan; Index < elementsInside; Index++)
+				{
+					const size_t Ahead = Index + PrefetchDistance;
+					if (Ahead < elementsInside)
+						detail::PrefetchForRead(Second + (Ahead - FirstSpan));
+					fn(Second[Index - FirstSpan]);
+				};
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			template<typename FuncT>
+			void RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::ForEach(FuncT&& fn, size_t PrefetchDistance) const
+			{
+				if (!MemoryBlock || !elementsInside)
+					return;
+
+				const size_t FirstSpan = elementsInside < capacity - tail ? elementsInside : capacity - tail;
+				const ValueT* First = PointToValueAtIndex(tail);
+				const ValueT* Second = PointToValueAtIndex(0);
+				for (size_t Index = 0; Index < FirstSpan; Index++)
+				{
+					const size_t Ahead = Index + PrefetchDistance;
+					if (Ahead < FirstSpan)
+						detail::PrefetchForRead(First + Ahead);
+					else if (Ahead < elementsInside)
+						detail::PrefetchForRead(Second + (Ahead - FirstSpan));
+					fn(First[Index]);
+				};
+				for (size_t Index = FirstSpan; Index < elementsInside; Index++)
+				{
+					const size_t Ahead = Index + PrefetchDistance;
+					if (Ahead < elementsInside)
+						detail::PrefetchForRead(Second + (Ahead - FirstSpan));
+					fn(Second[Index - FirstSpan]);
+				};
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::IndexedIterator RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PeekFront()
 			{
 				IndexedIterator result = end();
 
@@ -878,8 +2005,8 @@ namespace harz {
 				return result;
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			RingBuffer<ValueT, AllocatorT>::IndexedIterator RingBuffer<ValueT, AllocatorT>::PeekBack()
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::IndexedIterator RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PeekBack()
 			{
 				IndexedIterator result = end();
 
@@ -888,8 +2015,8 @@ namespace harz {
 				return result;
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			RingBuffer<ValueT, AllocatorT>::ConstIndexedIterator RingBuffer<ValueT, AllocatorT>::PeekFront() const
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::ConstIndexedIterator RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PeekFront() const
 			{
 				ConstIndexedIterator result = end();
 
@@ -898,8 +2025,8 @@ namespace harz {
 				return result;
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			RingBuffer<ValueT, AllocatorT>::ConstIndexedIterator RingBuffer<ValueT, AllocatorT>::PeekBack() const
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::ConstIndexedIterator RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PeekBack() const
 			{
 				ConstIndexedIterator result = end();
 
@@ -908,160 +2035,229 @@ namespace harz {
 				return result;
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			ValueT&& RingBuffer<ValueT, AllocatorT>::PopFront()
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			ValueT RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PopFront()
 			{
-				ValueT* Result = nullptr;
 				if (head != InvalidIndex())
 				{
-					Result = PointToValueAtIndex(head);
+					ValueT* Item = PointToValueAtIndex(head);
+					ValueT Result = std::move(*Item);
+					Item->~ValueT();
+					RING_BUFFER_STAT(stats.Pops++)
 					if (elementsInside > 1)
 					{
 						elementsInside--;
-						// Avoid "underflow?" if head == 0
-						if (head == 0)
-							head = capacity - 1;
-						else
-							head = head - 1 % capacity;
+						head = DecrementIndexWrapped(head);
 					}
 					else
 					{
 						head = InvalidIndex();
+						tail = InvalidIndex();
 						elementsInside = 0;
 					};
+					return Result;
 				}
-				if (Result)
-				{
-					return std::move(*Result);
-				};
 
 				return ValueT{};
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			ValueT&& RingBuffer<ValueT, AllocatorT>::PopBack()
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			ValueT RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PopBack()
 			{
-				ValueT* Result = nullptr;
 				if (GetTailIndex() != InvalidIndex())
 				{
-					Result = PointToValueAtIndex(GetTailIndex());
+					ValueT* Item = PointToValueAtIndex(GetTailIndex());
+					ValueT Result = std::move(*Item);
+					Item->~ValueT();
+					RING_BUFFER_STAT(stats.Pops++)
 					if (elementsInside > 1)
 					{
 						elementsInside--;
+						tail = IncrementIndexWrapped(tail);
 					}
 					else
 					{
 						head = InvalidIndex();
+						tail = InvalidIndex();
 						elementsInside = 0;
 					}
-				};
-
-				if (Result)
-				{
-					return std::move(*Result);
+					return Result;
 				};
 
 				return ValueT{};
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			ValueT* RingBuffer<ValueT, AllocatorT>::LookAtIndex(size_t index)
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			ValueT* RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::LookAtIndex(size_t index)
 			{
-				if (index >= capacity ||
-					elementsInside == 0 ||
-					index == InvalidIndex() ||
-					index < GetTailIndex() && index > GetHeadIndex() ||
-					index > GetTailIndex() && index > GetHeadIndex() && GetTailIndex() <= GetHeadIndex())
+				if (!IsIndexValid(index))
 					return nullptr;
 				return (ValueT*)GetData() + index;
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			const ValueT* RingBuffer<ValueT, AllocatorT>::LookAtIndex(size_t index) const
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			const ValueT* RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::LookAtIndex(size_t index) const
 			{
-				if (index >= capacity ||
-					elementsInside == 0 ||
-					index == InvalidIndex() ||
-					index < GetTailIndex() && index > GetHeadIndex() ||
-					index > GetTailIndex() && index > GetHeadIndex() && GetTailIndex() <= GetHeadIndex())
+				if (!IsIndexValid(index))
 					return nullptr;
 				return (ValueT*)GetData() + index;
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			bool RingBuffer<ValueT, AllocatorT>::Resize(size_t NewCapacity)
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			template<typename... ArgsT>
+			ValueT* RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::ReplaceAt(size_t index, ArgsT&&... args)
+			{
+				if (!IsIndexValid(index))
+					return nullptr;
+
+				ValueT* Item = PointToValueAtIndex(index);
+				Item->~ValueT();
+				new (Item) ValueT(std::forward<ArgsT>(args)...);
+				return Item;
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::Find(const ValueT& value) const
+			{
+				if (!elementsInside)
+					return InvalidIndex();
+
+				const ValueT* Base = (const ValueT*)GetData();
+
+				if (tail <= head)
+				{
+					const ValueT* Match = detail::FindValueInRange(Base + tail, Base + head + 1, value);
+					return Match ? (size_t)(Match - Base) : InvalidIndex();
+				};
+
+				// Occupied range wraps: search [tail .. capacity) first, then [0 .. head]
+				const ValueT* Match = detail::FindValueInRange(Base + tail, Base + capacity, value);
+				if (!Match)
+					Match = detail::FindValueInRange(Base, Base + head + 1, value);
+				return Match ? (size_t)(Match - Base) : InvalidIndex();
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			template<typename KeyT, typename KeyExtractT>
+			RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::IndexedIterator RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::FindFirstNotBefore(const KeyT& Key, KeyExtractT&& KeyExtract)
+			{
+				if (!elementsInside)
+					return end();
+
+				// Halving search over logical offsets [0, elementsInside). The step updates
+				// are compare-and-select, so the compiler keeps them as conditional moves -
+				// no branch to mispredict on the random probe outcomes
+				size_t Lo = 0;
+				size_t Count = elementsInside;
+				while (Count > 0)
+				{
+					const size_t Step = Count / 2;
+					size_t Physical = tail + Lo + Step;
+					if (Physical >= capacity)
+						Physical -= capacity;
+					const bool Before = KeyExtract(*PointToValueAtIndex(Physical)) < Key;
+					Lo = Before ? Lo + Step + 1 : Lo;
+					Count = Before ? Count - Step - 1 : Step;
+				};
+
+				if (Lo == elementsInside)
+					return end();
+
+				size_t Physical = tail + Lo;
+				if (Physical >= capacity)
+					Physical -= capacity;
+				return IndexedIterator{ *this, Physical, Iterators::EIndexedAccessIteratorPosition::InRange };
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			template<typename KeyT, typename KeyExtractT>
+			RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::ConstIndexedIterator RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::FindFirstNotBefore(const KeyT& Key, KeyExtractT&& KeyExtract) const
+			{
+				if (!elementsInside)
+					return end();
+
+				size_t Lo = 0;
+				size_t Count = elementsInside;
+				while (Count > 0)
+				{
+					const size_t Step = Count / 2;
+					size_t Physical = tail + Lo + Step;
+					if (Physical >= capacity)
+						Physical -= capacity;
+					const bool Before = KeyExtract(*PointToValueAtIndex(Physical)) < Key;
+					Lo = Before ? Lo + Step + 1 : Lo;
+					Count = Before ? Count - Step - 1 : Step;
+				};
+
+				if (Lo == elementsInside)
+					return end();
+
+				size_t Physical = tail + Lo;
+				if (Physical >= capacity)
+					Physical -= capacity;
+				return ConstIndexedIterator{ *this, Physical, Iterators::EIndexedAccessIteratorPosition::InRange };
+			};
+
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			bool RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::Resize(size_t NewCapacity)
 			{
+				if constexpr (Pow2Capacity)
+					NewCapacity = detail::RoundUpToPowerOfTwo(NewCapacity);
+
 				if (NewCapacity > 0 && NewCapacity != size_t(-1) && NewCapacity >= elementsInside)
 				{
-					ValueT** NewAllocatedMemory = (ValueT**)m_InternalAllocator.Allocate(NewCapacity * sizeof(ValueT));
+					ValueT** NewAllocatedMemory = (ValueT**)AllocateMemoryBlock(NewCapacity * sizeof(ValueT));
 					if (NewAllocatedMemory)
 					{
 						if (MemoryBlock)
 						{
 							if (elementsInside > 0 && head != InvalidIndex())
 							{
-								size_t TailIndex = 0;
-
-								if (GetTailIndex() != InvalidIndex())
-									TailIndex = GetTailIndex();
-
-								if (TailIndex > head)
+								if constexpr (std::is_trivially_copyable_v<ValueT>)
 								{
-									// Just copy value in loop
-									size_t StartIndexForTailPart = 0;
-									for (size_t copyIndex = TailIndex; copyIndex < capacity; copyIndex++)
+									// Trivial payloads relocate as whole segments, one or two memcpys
+									if (tail <= head)
 									{
-										*((ValueT*)NewAllocatedMemory + StartIndexForTailPart++) = *((ValueT*)MemoryBlock + copyIndex);
-									};
-									for (size_t copyIndex = 0; copyIndex <= head; copyIndex++)
+										detail::CopyMemory(PointToValueAtIndex(tail), NewAllocatedMemory, elementsInside * sizeof(ValueT));
+									}
+									else
 									{
-										*((ValueT*)NewAllocatedMemory + StartIndexForTailPart++) = *((ValueT*)MemoryBlock + copyIndex);
+										const size_t TailPartCount = capacity - tail;
+										detail::CopyMemory(PointToValueAtIndex(tail), NewAllocatedMemory, TailPartCount * sizeof(ValueT));
+										detail::CopyMemory(PointToValueAtIndex(0), (ValueT*)NewAllocatedMemory + TailPartCount, (head + 1) * sizeof(ValueT));
 									};
-
-									// Update info about container
-									head = elementsInside - 1;
 								}
 								else
 								{
-									// copy all elements into new container
-									detail::CopyMemory(GetData(), NewAllocatedMemory, head + 1 * sizeof(ValueT));
-								}
+									// Move-construct elements at the start of the new block, tail
+									// first, destroying each old element once it was carried over
+									size_t CopyIndex = tail;
+									for (size_t CopiedCount = 0; CopiedCount < elementsInside; CopiedCount++)
+									{
+										ValueT* OldItem = PointToValueAtIndex(CopyIndex);
+										new ((ValueT*)NewAllocatedMemory + CopiedCount) ValueT(std::move(*OldItem));
+										OldItem->~ValueT();
+										CopyIndex = IncrementIndexWrapped(CopyIndex);
+									};
+								};
+
+								// Update info about container
+								tail = 0;
+								head = elementsInside - 1;
 							};
 							m_InternalAllocator.Deallocate(GetData());
 						};
 						capacity = NewCapacity;
 						MemoryBlock = NewAllocatedMemory;
+						RING_BUFFER_STAT(stats.Resizes++)
 						return true;
 					};
 				};
 				return false;
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			size_t RingBuffer<ValueT, AllocatorT>::GetTailIndex() const
-			{
-				if (capacity == 0)
-				{
-					return InvalidIndex();
-				};
-
-				if (head == InvalidIndex())
-				{
-					return InvalidIndex();
-				};
-
-				RING_BUFFER_ASSERT(elementsInside > 0);
-
-				if (elementsInside == 1)
-				{
-					return head;
-				};
-
-				return head < elementsInside - 1 ? capacity - (elementsInside - head - 1) : head - (elementsInside - 1);
-			};
-
-			template<typename ValueT, typename AllocatorT>
-			inline ValueT* RingBuffer<ValueT, AllocatorT>::PointToValueAtIndex(size_t index)
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			inline ValueT* RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PointToValueAtIndex(size_t index)
 			{
 				if (index >= capacity)
 					return nullptr;
@@ -1069,8 +2265,8 @@ namespace harz {
 				return (ValueT*)GetData() + index;
 			}
 
-			template<typename ValueT, typename AllocatorT>
-			inline const ValueT* RingBuffer<ValueT, AllocatorT>::PointToValueAtIndex(size_t index) const
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			inline const ValueT* RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::PointToValueAtIndex(size_t index) const
 			{
 				if (index >= capacity)
 					return nullptr;
@@ -1078,25 +2274,25 @@ namespace harz {
 				return (ValueT*)GetData() + index;
 			}
 
-			template<typename ValueT, typename AllocatorT>
-			inline size_t RingBuffer<ValueT, AllocatorT>::GetNextHeadIndex() const
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			inline size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::GetNextHeadIndex() const
 			{
 				if (capacity == 0 || capacity == elementsInside)
 				{
 					return InvalidIndex();
 				}
-				size_t NextIndex = head == capacity - 1 ? 0 : head + 1;
+				size_t NextIndex = IncrementIndexWrapped(head);
 				return NextIndex;
 			};
 
-			template<typename ValueT, typename AllocatorT>
-			inline size_t RingBuffer<ValueT, AllocatorT>::GetNextTailIndex() const
+			template<typename ValueT, typename AllocatorT, bool Pow2Capacity, bool PaddedLayout>
+			inline size_t RingBuffer<ValueT, AllocatorT, Pow2Capacity, PaddedLayout>::GetNextTailIndex() const
 			{
 				if (capacity == 0 || capacity == elementsInside)
 				{
 					return InvalidIndex();
 				}
-				size_t NextIndex = GetTailIndex() == 0 ? capacity - 1 : GetTailIndex() - 1;
+				size_t NextIndex = DecrementIndexWrapped(GetTailIndex());
 				return NextIndex;
 			};
 
@@ -0,0 +1,346 @@
+#pragma once
+/// -----------------------------------------------------------------------------
+///
+/// BSD 3-Clause License
+/// Copyright(c) 2023-2024, (IHarzI) Maslianka Zakhar
+///
+/// -----------------------------------------------------------------------------
+
+#include "RingBuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace harz {
+	namespace Containers {
+		namespace RingBufferImplementation {
+
+			// Single Producer/Single Consumer lock-free ring buffer.
+			// Exactly one thread may call push operations and exactly one (possibly different)
+			// thread may call pop operations, without any external locking.
+			// Indices are published with acquire/release ordering and kept on separate cache lines,
+			// so producer and consumer never contend on the same line.
+			// Allocator Type must have the same contract as for RingBuffer:
+			// Allocate(size_t bytes_to_allocate), Deallocate(void* MemoryToDeallocate)
+			// and be **Copy/Default Constructable**
+			// Value Type must be Default constructable and movable
+#ifdef RING_BUFFER_USE_SIMPLE_ALLOCATOR
+			template<typename ValueT, typename AllocatorT = utils::TEST_SIMPLE_ALLOCATOR_FOR_RING_BUFFER>
+#else
+			template<typename ValueT, typename AllocatorT>
+#endif
+			class SPSCRingBuffer
+			{
+			public:
+				SPSCRingBuffer();
+				SPSCRingBuffer(size_t capacity);
+				~SPSCRingBuffer();
+
+				// Not copyable/movable, two threads could be touching the indices while we copy them
+				SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+				SPSCRingBuffer& operator=(const SPSCRingBuffer&) = delete;
+
+				// Push element to the back of the ring. Producer thread only.
+				// Returns slot index of the pushed element, or InvalidIndex if the ring is full
+				size_t PushBack(ValueT value);
+
+				// Emplace element to the back of the ring. Producer thread only.
+				// Returns slot index of the emplaced element, or InvalidIndex if the ring is full
+				size_t EmplaceBack(ValueT&& value);
+
+				// Pop element from the front of the ring into OutValue. Consumer thread only.
+				// Returns false if the ring is empty
+				bool PopFront(ValueT& OutValue);
+
+				// Look at the first front element. Consumer thread only,
+				// the pointer stays valid until the consumer pops past it
+				ValueT* PeekFront();
+
+				// Blocking variants: spin briefly with detail::SpinPause, then park on a
+				// condition variable until the other side makes progress or the timeout
+				// passes. The mutex is only ever touched by a thread about to sleep (or
+				// waking one that does), so the lock-free fast path stays lock-free.
+				// Same thread roles as the non-blocking calls.
+				// WaitPushBack returns the slot index or InvalidIndex on timeout
+				template<typename RepT, typename PeriodT>
+				size_t WaitPushBack(ValueT value, const std::chrono::duration<RepT, PeriodT>& Timeout);
+
+				// WaitPopFront returns false on timeout
+				template<typename RepT, typename PeriodT>
+				bool WaitPopFront(ValueT& OutValue, const std::chrono::duration<RepT, PeriodT>& Timeout);
+
+				// Get capacity
+				inline size_t GetCapacity() const { return capacity; };
+
+				// Get number of elements inside. Only an estimate while the other thread is pushing/popping
+				inline size_t GetSize() const
+				{
+					const size_t CurrentTail = tail.load(std::memory_order_acquire);
+					const size_t CurrentHead = head.load(std::memory_order_acquire);
+					return CurrentTail >= CurrentHead ? CurrentTail - CurrentHead : SlotsCount() - (CurrentHead - CurrentTail);
+				};
+
+				inline bool IsEmpty() const { return GetSize() == 0; };
+
+				// Destroy all elements inside. NOT thread safe, both threads must be stopped
+				void Clear();
+
+				inline const size_t InvalidIndex() const { return size_t(-1); };
+
+#ifdef RING_BUFFER_ENABLE_STATS
+				// Snapshot/reset of the traffic counters, only compiled in with RING_BUFFER_ENABLE_STATS.
+				// Counters are bumped with relaxed atomics from whichever thread did the work,
+				// GetStats may be called from any thread
+				inline RingBufferStats GetStats() const { return stats.Snapshot(); };
+				inline void ResetStats() { stats.Reset(); };
+#endif
+
+			private:
+				// One slot is kept empty to tell a full ring from an empty one,
+				// so internally we allocate capacity + 1 slots
+				inline size_t SlotsCount() const { return capacity + 1; };
+
+				inline size_t GetNextIndex(size_t index) const
+				{
+					return index == SlotsCount() - 1 ? 0 : index + 1;
+				};
+
+				inline ValueT* PointToValueAtIndex(size_t index)
+				{
+					return (ValueT*)MemoryBlock + index;
+				};
+
+				static const size_t CacheLineSize = RING_BUFFER_CACHE_LINE_SIZE;
+				// Spins taken before a Wait* call parks; roughly a microsecond of
+				// polling, which catches almost every message on a busy ring
+				static const size_t SpinsBeforeWait = 1024;
+
+				AllocatorT m_InternalAllocator = AllocatorT{};
+				ValueT* MemoryBlock = nullptr;
+				size_t capacity = 0;
+
+				// Consumer-owned index of the next slot to pop, padded onto its own cache line
+				alignas(CacheLineSize) std::atomic<size_t> head = 0;
+				// Producer-owned index of the next slot to push, padded onto its own cache line
+				alignas(CacheLineSize) std::atomic<size_t> tail = 0;
+				char PadAfterIndices[CacheLineSize - sizeof(std::atomic<size_t>)] = {};
+
+				// Blocking support: a sleeper raises its flag, publishes it with a full
+				// fence, re-checks the ring and only then waits; the opposite side fences
+				// after publishing its index and notifies whenever it sees a raised flag
+				std::mutex waitMutex;
+				std::condition_variable waitCondition;
+				std::atomic<size_t> waitingConsumers = 0;
+				std::atomic<size_t> waitingProducers = 0;
+
+#ifdef RING_BUFFER_ENABLE_STATS
+				RingBufferAtomicStats stats = {};
+#endif
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			SPSCRingBuffer<ValueT, AllocatorT>::SPSCRingBuffer()
+			{
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			SPSCRingBuffer<ValueT, AllocatorT>::SPSCRingBuffer(size_t capacity)
+			{
+				if (capacity > 0 && capacity != InvalidIndex())
+				{
+					MemoryBlock = (ValueT*)m_InternalAllocator.Allocate((capacity + 1) * (sizeof(ValueT)));
+					if (MemoryBlock)
+					{
+						this->capacity = capacity;
+					}
+				};
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			SPSCRingBuffer<ValueT, AllocatorT>::~SPSCRingBuffer()
+			{
+				if (MemoryBlock)
+				{
+					Clear();
+					m_InternalAllocator.Deallocate(MemoryBlock);
+				}
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			size_t SPSCRingBuffer<ValueT, AllocatorT>::PushBack(ValueT value)
+			{
+				return EmplaceBack(std::move(value));
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			size_t SPSCRingBuffer<ValueT, AllocatorT>::EmplaceBack(ValueT&& value)
+			{
+				if (!MemoryBlock)
+					return InvalidIndex();
+
+				const size_t CurrentTail = tail.load(std::memory_order_relaxed);
+				const size_t NextTail = GetNextIndex(CurrentTail);
+
+				// Ring is full if the next write slot would collide with the consumer
+				if (NextTail == head.load(std::memory_order_acquire))
+				{
+					RING_BUFFER_STAT(stats.FailedPushes.fetch_add(1, std::memory_order_relaxed))
+					return InvalidIndex();
+				};
+
+				new (PointToValueAtIndex(CurrentTail)) ValueT(std::move(value));
+
+				// Publish the slot to the consumer
+				tail.store(NextTail, std::memory_order_release);
+				RING_BUFFER_STAT(stats.Pushes.fetch_add(1, std::memory_order_relaxed))
+				RING_BUFFER_STAT(if (NextTail == 0) stats.Wraps.fetch_add(1, std::memory_order_relaxed))
+				RING_BUFFER_STAT(stats.UpdateHighWaterMark(GetSize()))
+
+				// The tail store must be visible before the flag check, or a consumer
+				// parking right now could re-check an empty ring and then miss our notify
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (waitingConsumers.load(std::memory_order_relaxed))
+				{
+					// Empty lock/unlock closes the race with a consumer between
+					// its re-check and its wait
+					{ std::lock_guard<std::mutex> Lock(waitMutex); };
+					waitCondition.notify_one();
+				};
+
+				return CurrentTail;
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			bool SPSCRingBuffer<ValueT, AllocatorT>::PopFront(ValueT& OutValue)
+			{
+				if (!MemoryBlock)
+					return false;
+
+				const size_t CurrentHead = head.load(std::memory_order_relaxed);
+
+				// Ring is empty if the read slot caught up with the producer
+				if (CurrentHead == tail.load(std::memory_order_acquire))
+					return false;
+
+				ValueT* Item = PointToValueAtIndex(CurrentHead);
+				OutValue = std::move(*Item);
+				Item->~ValueT();
+
+				// Release the slot back to the producer
+				head.store(GetNextIndex(CurrentHead), std::memory_order_release);
+				RING_BUFFER_STAT(stats.Pops.fetch_add(1, std::memory_order_relaxed))
+
+				// Mirror of the push side - wake a producer parked on a full ring
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (waitingProducers.load(std::memory_order_relaxed))
+				{
+					{ std::lock_guard<std::mutex> Lock(waitMutex); };
+					waitCondition.notify_one();
+				};
+
+				return true;
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			template<typename RepT, typename PeriodT>
+			size_t SPSCRingBuffer<ValueT, AllocatorT>::WaitPushBack(ValueT value, const std::chrono::duration<RepT, PeriodT>& Timeout)
+			{
+				if (!MemoryBlock)
+					return InvalidIndex();
+
+				// Fast path - on a ring that drains at all, a slot frees up while spinning
+				for (size_t Spin = 0; Spin < SpinsBeforeWait; Spin++)
+				{
+					const size_t Index = EmplaceBack(std::move(value));
+					if (Index != InvalidIndex())
+						return Index;
+					detail::SpinPause();
+				};
+
+				const auto Deadline = std::chrono::steady_clock::now() + Timeout;
+				std::unique_lock<std::mutex> Lock(waitMutex);
+				waitingProducers.fetch_add(1, std::memory_order_relaxed);
+				// The raised flag must be visible before the re-check below, or a pop
+				// landing in between could skip its notify and leave us sleeping
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+
+				// Wait on the lock-free fullness check; the actual push happens after the
+				// lock is dropped - we are the only producer, so a freed slot stays free
+				bool TimedOut = false;
+				while (GetSize() >= capacity && !TimedOut)
+					TimedOut = waitCondition.wait_until(Lock, Deadline) == std::cv_status::timeout;
+
+				waitingProducers.fetch_sub(1, std::memory_order_relaxed);
+				Lock.unlock();
+
+				return EmplaceBack(std::move(value));
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			template<typename RepT, typename PeriodT>
+			bool SPSCRingBuffer<ValueT, AllocatorT>::WaitPopFront(ValueT& OutValue, const std::chrono::duration<RepT, PeriodT>& Timeout)
+			{
+				if (!MemoryBlock)
+					return false;
+
+				// Fast path - on a busy ring almost every message is caught while spinning
+				for (size_t Spin = 0; Spin < SpinsBeforeWait; Spin++)
+				{
+					if (PopFront(OutValue))
+						return true;
+					detail::SpinPause();
+				};
+
+				const auto Deadline = std::chrono::steady_clock::now() + Timeout;
+				std::unique_lock<std::mutex> Lock(waitMutex);
+				waitingConsumers.fetch_add(1, std::memory_order_relaxed);
+				// See WaitPushBack - flag first, then re-check, then sleep
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+
+				// Wait on the lock-free emptiness check; the actual pop happens after the
+				// lock is dropped - we are the only consumer, so a landed element stays in
+				bool TimedOut = false;
+				while (IsEmpty() && !TimedOut)
+					TimedOut = waitCondition.wait_until(Lock, Deadline) == std::cv_status::timeout;
+
+				waitingConsumers.fetch_sub(1, std::memory_order_relaxed);
+				Lock.unlock();
+
+				return PopFront(OutValue);
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			ValueT* SPSCRingBuffer<ValueT, AllocatorT>::PeekFront()
+			{
+				if (!MemoryBlock)
+					return nullptr;
+
+				const size_t CurrentHead = head.load(std::memory_order_relaxed);
+
+				if (CurrentHead == tail.load(std::memory_order_acquire))
+					return nullptr;
+
+				return PointToValueAtIndex(CurrentHead);
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			void SPSCRingBuffer<ValueT, AllocatorT>::Clear()
+			{
+				size_t CurrentHead = head.load(std::memory_order_relaxed);
+				const size_t CurrentTail = tail.load(std::memory_order_relaxed);
+				while (CurrentHead != CurrentTail)
+				{
+					PointToValueAtIndex(CurrentHead)->~ValueT();
+					CurrentHead = GetNextIndex(CurrentHead);
+				};
+				head.store(0, std::memory_order_relaxed);
+				tail.store(0, std::memory_order_relaxed);
+			};
+
+		};
+	};
+};
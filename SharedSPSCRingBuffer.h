@@ -0,0 +1,210 @@
+#pragma once
+/// -----------------------------------------------------------------------------
+///
+/// BSD 3-Clause License
+/// Copyright(c) 2023-2024, (IHarzI) Maslianka Zakhar
+///
+/// -----------------------------------------------------------------------------
+
+#include "RingBuffer.h"
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+namespace harz {
+	namespace Containers {
+		namespace RingBufferImplementation {
+
+			// Single Producer/Single Consumer ring living entirely inside a caller-provided
+			// memory region - typically a shared memory segment mapped by two processes, so
+			// events move between them without a copy, a syscall or a wakeup per batch.
+			// The control block (capacity + head/tail indices) sits at the start of the
+			// region, the slot storage follows it; this class is only a view and never
+			// owns or frees the region. One process calls CreateInPlace once to lay out
+			// the control block, every other participant attaches with OpenInPlace.
+			// Same threading contract as SPSCRingBuffer: exactly one pusher and exactly
+			// one popper, indices published with acquire/release ordering.
+			// Value Type must be trivially copyable - the region outlives any single
+			// process, so elements must not carry pointers to process-local resources
+			template<typename ValueT>
+			class SharedSPSCRingBuffer
+			{
+				static_assert(std::is_trivially_copyable_v<ValueT>,
+					"SharedSPSCRingBuffer elements cross a process boundary and must be trivially copyable");
+
+			public:
+
+				SharedSPSCRingBuffer() = default;
+				SharedSPSCRingBuffer(const SharedSPSCRingBuffer&) = default;
+				SharedSPSCRingBuffer& operator=(const SharedSPSCRingBuffer&) = default;
+
+				// Bytes the region must provide for a ring of the given capacity
+				// (control block + capacity + 1 slots, see SlotsCount in SPSCRingBuffer)
+				static inline constexpr size_t RequiredMemorySize(size_t capacity)
+				{
+					return sizeof(ControlBlock) + (capacity + 1) * sizeof(ValueT);
+				};
+
+				// Lay the control block out in the region and return a view over it.
+				// Capacity is derived from the region size - as many slots as fit after
+				// the control block, minus the one kept empty. The region must stay
+				// mapped for as long as any view is used and should be page (or at
+				// least cache line) aligned, which any shm mapping already is.
+				// Returns an invalid view if the region cannot hold a single element
+				static SharedSPSCRingBuffer CreateInPlace(void* region, size_t bytes)
+				{
+					SharedSPSCRingBuffer Result;
+					if (!region || bytes < RequiredMemorySize(1))
+						return Result;
+
+					const size_t Slots = (bytes - sizeof(ControlBlock)) / sizeof(ValueT);
+
+					ControlBlock* Control = new (region) ControlBlock{};
+					Control->Capacity = Slots - 1;
+					Control->Magic = ControlBlockMagic;
+
+					Result.Control = Control;
+					Result.Slots = (ValueT*)((unsigned char*)region + sizeof(ControlBlock));
+					return Result;
+				};
+
+				// Attach to a region another process (or this one) already initialized
+				// with CreateInPlace. Returns an invalid view if the control block is
+				// missing or the region is smaller than the capacity it claims
+				static SharedSPSCRingBuffer OpenInPlace(void* region, size_t bytes)
+				{
+					SharedSPSCRingBuffer Result;
+					if (!region || bytes < sizeof(ControlBlock))
+						return Result;
+
+					ControlBlock* Control = (ControlBlock*)region;
+					if (Control->Magic != ControlBlockMagic || bytes < RequiredMemorySize(Control->Capacity))
+						return Result;
+
+					Result.Control = Control;
+					Result.Slots = (ValueT*)((unsigned char*)region + sizeof(ControlBlock));
+					return Result;
+				};
+
+				// A view is usable only after a successful CreateInPlace/OpenInPlace
+				inline bool IsValid() const { return Control != nullptr; };
+
+				// Push element to the back of the ring. Producer side only.
+				// Returns slot index of the pushed element, or InvalidIndex if the ring is full
+				size_t PushBack(ValueT value)
+				{
+					if (!Control)
+						return InvalidIndex();
+
+					const size_t CurrentTail = Control->Tail.load(std::memory_order_relaxed);
+					const size_t NextTail = GetNextIndex(CurrentTail);
+
+					// Ring is full if the next write slot would collide with the consumer
+					if (NextTail == Control->Head.load(std::memory_order_acquire))
+						return InvalidIndex();
+
+					Slots[CurrentTail] = value;
+
+					// Publish the slot to the consumer
+					Control->Tail.store(NextTail, std::memory_order_release);
+					return CurrentTail;
+				};
+
+				// Pop element from the front of the ring into OutValue. Consumer side only.
+				// Returns false if the ring is empty
+				bool PopFront(ValueT& OutValue)
+				{
+					if (!Control)
+						return false;
+
+					const size_t CurrentHead = Control->Head.load(std::memory_order_relaxed);
+
+					// Ring is empty if the read slot caught up with the producer
+					if (CurrentHead == Control->Tail.load(std::memory_order_acquire))
+						return false;
+
+					OutValue = Slots[CurrentHead];
+
+					// Release the slot back to the producer
+					Control->Head.store(GetNextIndex(CurrentHead), std::memory_order_release);
+					return true;
+				};
+
+				// Look at the first front element. Consumer side only,
+				// the pointer stays valid until the consumer pops past it
+				ValueT* PeekFront()
+				{
+					if (!Control)
+						return nullptr;
+
+					const size_t CurrentHead = Control->Head.load(std::memory_order_relaxed);
+
+					if (CurrentHead == Control->Tail.load(std::memory_order_acquire))
+						return nullptr;
+
+					return Slots + CurrentHead;
+				};
+
+				// Get capacity recorded in the control block
+				inline size_t GetCapacity() const { return Control ? Control->Capacity : 0; };
+
+				// Get number of elements inside. Only an estimate while the other side is pushing/popping
+				inline size_t GetSize() const
+				{
+					if (!Control)
+						return 0;
+					const size_t CurrentTail = Control->Tail.load(std::memory_order_acquire);
+					const size_t CurrentHead = Control->Head.load(std::memory_order_acquire);
+					return CurrentTail >= CurrentHead ? CurrentTail - CurrentHead : SlotsCount() - (CurrentHead - CurrentTail);
+				};
+
+				inline bool IsEmpty() const { return GetSize() == 0; };
+
+				// Reset the ring to empty. NOT thread safe, both sides must be stopped
+				void Clear()
+				{
+					if (!Control)
+						return;
+					Control->Head.store(0, std::memory_order_relaxed);
+					Control->Tail.store(0, std::memory_order_relaxed);
+				};
+
+				inline const size_t InvalidIndex() const { return size_t(-1); };
+
+			private:
+				// Part of the in-region layout - every process mapping the region must be
+				// built with the same RING_BUFFER_CACHE_LINE_SIZE
+				static const size_t CacheLineSize = RING_BUFFER_CACHE_LINE_SIZE;
+				// "HRZRING1", stamps an initialized control block for OpenInPlace
+				static const size_t ControlBlockMagic = 0x48525A52494E4731;
+
+				static_assert(alignof(ValueT) <= CacheLineSize,
+					"slot storage starts right after the cache-line-aligned control block");
+
+				// Lives at the start of the shared region, both indices on their own
+				// cache line so producer and consumer never contend on the same one
+				struct ControlBlock
+				{
+					size_t Magic = 0;
+					size_t Capacity = 0;
+					alignas(CacheLineSize) std::atomic<size_t> Head = 0;
+					alignas(CacheLineSize) std::atomic<size_t> Tail = 0;
+					char PadAfterIndices[CacheLineSize - sizeof(std::atomic<size_t>)] = {};
+				};
+
+				// One slot is kept empty to tell a full ring from an empty one
+				inline size_t SlotsCount() const { return Control->Capacity + 1; };
+
+				inline size_t GetNextIndex(size_t index) const
+				{
+					return index == SlotsCount() - 1 ? 0 : index + 1;
+				};
+
+				ControlBlock* Control = nullptr;
+				ValueT* Slots = nullptr;
+			};
+
+		};
+	};
+};
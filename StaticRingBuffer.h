@@ -0,0 +1,424 @@
+#pragma once
+/// -----------------------------------------------------------------------------
+///
+/// BSD 3-Clause License
+/// Copyright(c) 2023-2024, (IHarzI) Maslianka Zakhar
+///
+/// -----------------------------------------------------------------------------
+
+#include "RingBuffer.h"
+
+namespace harz {
+	namespace Containers {
+		namespace RingBufferImplementation {
+
+			// Fixed-capacity ring buffer with inline storage - no allocator, no heap, the
+			// whole container is one object (like std::array is to std::vector), so it can
+			// live on the stack or inside another struct without an indirection.
+			// Storage is a plain ValueT array, elements exist for the lifetime of the
+			// container and pushes assign into their slot, therefore Value Type must be
+			// **Default constructable and Copy/Move assignable**
+			// That storage choice also makes the container constexpr-usable (C++20): all
+			// push/pop/access paths are constant-expression friendly, so a table can be
+			// built inside a consteval function and frozen into .rodata -
+			//   static constexpr auto Schedule = [] { StaticRingBuffer<int, 8> Ring;
+			//       for (int i = 0; i < 8; i++) Ring.PushBack(i * i); return Ring; }();
+			// Iteration is the runtime convenience path; compile-time code reads through
+			// operator[]/PopFront instead
+			template<typename ValueT, size_t Capacity>
+			class StaticRingBuffer
+			{
+				static_assert(Capacity > 0 && Capacity != size_t(-1), "StaticRingBuffer needs a valid non-zero capacity");
+			public:
+
+				using IndexedIterator = Iterators::TIndexedIteratorBase<StaticRingBuffer, ValueT, size_t, false>;
+				using ConstIndexedIterator = Iterators::TIndexedIteratorBase<StaticRingBuffer, ValueT, size_t, true>;
+
+				StaticRingBuffer() = default;
+				StaticRingBuffer(const StaticRingBuffer& Other) = default;
+				StaticRingBuffer(StaticRingBuffer&& Other) = default;
+				StaticRingBuffer& operator=(const StaticRingBuffer& Other) = default;
+
+				// Push element to the back. Returns slot index, or InvalidIndex if the ring is full
+				inline constexpr size_t PushBack(ValueT value)
+				{
+					if (Capacity > elementsInside)
+					{
+						size_t IndexForPushedElement = 0;
+						if (tail != InvalidIndex())
+							IndexForPushedElement = DecrementIndexWrapped(tail);
+
+						Storage[IndexForPushedElement] = std::move(value);
+						elementsInside++;
+						tail = IndexForPushedElement;
+						if (head == InvalidIndex())
+							head = IndexForPushedElement;
+						RING_BUFFER_STAT(StatsOnPush(elementsInside > 1 && IndexForPushedElement == Capacity - 1))
+						return IndexForPushedElement;
+					};
+					RING_BUFFER_STAT(stats.FailedPushes++)
+					return InvalidIndex();
+				};
+
+				// Push element to the front. Returns slot index, or InvalidIndex if the ring is full
+				inline constexpr size_t PushFront(ValueT value)
+				{
+					if (Capacity > elementsInside)
+					{
+						size_t IndexForPushedElement = 0;
+						if (head != InvalidIndex())
+							IndexForPushedElement = IncrementIndexWrapped(head);
+
+						Storage[IndexForPushedElement] = std::move(value);
+						elementsInside++;
+						head = IndexForPushedElement;
+						if (tail == InvalidIndex())
+							tail = IndexForPushedElement;
+						RING_BUFFER_STAT(StatsOnPush(elementsInside > 1 && IndexForPushedElement == 0))
+						return IndexForPushedElement;
+					};
+					RING_BUFFER_STAT(stats.FailedPushes++)
+					return InvalidIndex();
+				};
+
+				// Build the element from constructor arguments and assign it into its slot
+				template<typename... ArgsT>
+				inline constexpr size_t EmplaceBack(ArgsT&&... args)
+				{
+					return PushBack(ValueT(std::forward<ArgsT>(args)...));
+				};
+
+				template<typename... ArgsT>
+				inline constexpr size_t EmplaceFront(ArgsT&&... args)
+				{
+					return PushFront(ValueT(std::forward<ArgsT>(args)...));
+				};
+
+				// Pop element from front. The slot keeps a moved-from value
+				inline constexpr ValueT PopFront()
+				{
+					if (head != InvalidIndex())
+					{
+						ValueT Result = std::move(Storage[head]);
+						RING_BUFFER_STAT(stats.Pops++)
+						if (elementsInside > 1)
+						{
+							elementsInside--;
+							head = DecrementIndexWrapped(head);
+						}
+						else
+						{
+							head = InvalidIndex();
+							tail = InvalidIndex();
+							elementsInside = 0;
+						};
+						return Result;
+					};
+					return ValueT{};
+				};
+
+				// Pop element from back. The slot keeps a moved-from value
+				inline constexpr ValueT PopBack()
+				{
+					if (tail != InvalidIndex())
+					{
+						ValueT Result = std::move(Storage[tail]);
+						RING_BUFFER_STAT(stats.Pops++)
+						if (elementsInside > 1)
+						{
+							elementsInside--;
+							tail = IncrementIndexWrapped(tail);
+						}
+						else
+						{
+							head = InvalidIndex();
+							tail = InvalidIndex();
+							elementsInside = 0;
+						};
+						return Result;
+					};
+					return ValueT{};
+				};
+
+				inline constexpr ValueT& Front() { RING_BUFFER_ASSERT(elementsInside); return Storage[head]; };
+				inline constexpr const ValueT& Front() const { RING_BUFFER_ASSERT(elementsInside); return Storage[head]; };
+				inline constexpr ValueT& Back() { RING_BUFFER_ASSERT(elementsInside); return Storage[tail]; };
+				inline constexpr const ValueT& Back() const { RING_BUFFER_ASSERT(elementsInside); return Storage[tail]; };
+
+				inline constexpr void Clear()
+				{
+					head = InvalidIndex();
+					tail = InvalidIndex();
+					elementsInside = 0;
+				};
+
+				// Get capacity, known at compile time
+				static inline constexpr size_t GetCapacity() { return Capacity; };
+
+				// Get number of elements inside
+				inline constexpr size_t GetSize() const { return elementsInside; };
+
+				inline constexpr bool IsEmpty() const { return elementsInside == 0; };
+				inline constexpr bool IsFull() const { return elementsInside == Capacity; };
+
+				// Get head index, in case of 0 elements, result will be InvalidIndex
+				inline constexpr size_t GetHeadIndex() const { return head; };
+
+				// Get tail index, in case of 0 elements, result will be InvalidIndex
+				inline constexpr size_t GetTailIndex() const { return tail; };
+
+				// Stuff for convenient loop and useful operators
+				inline constexpr ValueT& operator[](size_t index) { RING_BUFFER_ASSERT(index < Capacity); return Storage[index]; };
+				inline constexpr const ValueT& operator[](size_t index) const { RING_BUFFER_ASSERT(index < Capacity); return Storage[index]; };
+
+				inline constexpr ValueT& at(size_t index) { RING_BUFFER_ASSERT(index < Capacity); return Storage[index]; };
+				inline constexpr const ValueT& at(size_t index) const { RING_BUFFER_ASSERT(index < Capacity); return Storage[index]; };
+
+				// Same as GetSize, for ranges
+				inline constexpr size_t size() const { return elementsInside; };
+
+				inline constexpr ValueT* data() noexcept { return Storage; };
+				inline constexpr const ValueT* data() const noexcept { return Storage; };
+
+				inline constexpr const size_t InvalidIndex() const { return size_t(-1); };
+
+				inline IndexedIterator begin()
+				{
+					if (elementsInside)
+						return IndexedIterator{ *this, GetBeginIndex(), Iterators::EIndexedAccessIteratorPosition::Begin };
+
+					return end();
+				};
+
+				inline IndexedIterator end()
+				{
+					return IndexedIterator{ *this, InvalidIndex(), Iterators::EIndexedAccessIteratorPosition::End };
+				};
+
+				inline ConstIndexedIterator begin() const
+				{
+					if (elementsInside)
+						return ConstIndexedIterator{ *this, GetBeginIndex(), Iterators::EIndexedAccessIteratorPosition::Begin };
+
+					return end();
+				};
+
+				inline ConstIndexedIterator end() const
+				{
+					return ConstIndexedIterator{ *this, InvalidIndex(), Iterators::EIndexedAccessIteratorPosition::End };
+				};
+
+				// The whole occupied range as (at most two) contiguous runs in begin->end order,
+				// for flat loops over the elements. Returns the number of runs filled
+				inline constexpr size_t GetContiguousSegments(RingBufferSpan<ValueT> OutSpans[2])
+				{
+					OutSpans[0] = {};
+					OutSpans[1] = {};
+
+					if (!elementsInside)
+						return 0;
+
+					const size_t FirstSpan = elementsInside < Capacity - tail ? elementsInside : Capacity - tail;
+					OutSpans[0] = { Storage + tail, FirstSpan };
+					if (elementsInside > FirstSpan)
+						OutSpans[1] = { Storage, elementsInside - FirstSpan };
+
+					return OutSpans[1].Count ? 2 : 1;
+				};
+
+				inline constexpr size_t GetContiguousSegments(RingBufferSpan<const ValueT> OutSpans[2]) const
+				{
+					OutSpans[0] = {};
+					OutSpans[1] = {};
+
+					if (!elementsInside)
+						return 0;
+
+					const size_t FirstSpan = elementsInside < Capacity - tail ? elementsInside : Capacity - tail;
+					OutSpans[0] = { Storage + tail, FirstSpan };
+					if (elementsInside > FirstSpan)
+						OutSpans[1] = { Storage, elementsInside - FirstSpan };
+
+					return OutSpans[1].Count ? 2 : 1;
+				};
+
+				// Replace the element at index with one built from the arguments - assigned
+				// into its slot, matching how pushes store elements here. Bounds-checked
+				// like IsIndexValid; returns the new element, or nullptr for an invalid index
+				template<typename... ArgsT>
+				inline constexpr ValueT* ReplaceAt(size_t index, ArgsT&&... args)
+				{
+					if (!IsIndexValid(index))
+						return nullptr;
+
+					Storage[index] = ValueT(std::forward<ArgsT>(args)...);
+					return Storage + index;
+				};
+
+				// Drain through a callback: walks the occupied range oldest-first over its
+				// (at most two) contiguous runs, calls fn(element) on each and updates the
+				// indices once at the end. Slots keep their last value (storage is a plain
+				// array, see the class note), matching the pop semantics of this container.
+				// ConsumeUpTo stops after count elements. Both return how many were consumed.
+				// The callback must not push/pop on this ring
+				template<typename FuncT>
+				inline constexpr size_t ConsumeAll(FuncT&& fn)
+				{
+					return ConsumeUpTo(elementsInside, std::forward<FuncT>(fn));
+				};
+
+				template<typename FuncT>
+				inline constexpr size_t ConsumeUpTo(size_t count, FuncT&& fn)
+				{
+					if (!count || !elementsInside)
+						return 0;
+
+					const size_t ToConsume = count < elementsInside ? count : elementsInside;
+
+					const size_t FirstSpan = ToConsume < Capacity - tail ? ToConsume : Capacity - tail;
+					for (size_t consumed = 0; consumed < FirstSpan; consumed++)
+						fn(Storage[tail + consumed]);
+					for (size_t consumed = FirstSpan; consumed < ToConsume; consumed++)
+						fn(Storage[consumed - FirstSpan]);
+
+					elementsInside -= ToConsume;
+					RING_BUFFER_STAT(stats.Pops += ToConsume)
+					if (elementsInside)
+						tail = tail + ToConsume < Capacity ? tail + ToConsume : tail + ToConsume - Capacity;
+					else
+					{
+						head = InvalidIndex();
+						tail = InvalidIndex();
+					};
+
+					return ToConsume;
+				};
+
+				// Position of a slot inside the occupied range counted from begin (the tail),
+				// InvalidIndex for an empty ring. O(1), used for iterator distance
+				inline constexpr size_t GetLogicalIndex(size_t Index) const
+				{
+					if (!elementsInside || Index == InvalidIndex())
+						return InvalidIndex();
+					return Index >= tail ? Index - tail : Index + Capacity - tail;
+				};
+
+#ifdef RING_BUFFER_ENABLE_STATS
+				// Snapshot/reset of the traffic counters, only compiled in with RING_BUFFER_ENABLE_STATS
+				inline RingBufferStats GetStats() const { return stats; };
+				inline constexpr void ResetStats() { stats = {}; };
+#endif
+
+				inline constexpr bool IsIndexValid(size_t Index) const
+				{
+					// A slot is occupied iff its logical offset from the tail lands inside the
+					// element count - one subtract-and-wrap plus two compares, instead of the
+					// old five-way head/tail case split. Hot on every iterator step
+					return Index < Capacity && GetLogicalIndex(Index) < elementsInside;
+				};
+
+			private:
+				friend IndexedIterator;
+				friend ConstIndexedIterator;
+
+				inline constexpr size_t GetBeginIndex() const { return tail; };
+				inline constexpr size_t GetEndIndex() const { return head; };
+
+				inline constexpr size_t IncrementIndexWrapped(size_t index) const
+				{
+					return index == Capacity - 1 ? 0 : index + 1;
+				};
+
+				inline constexpr size_t DecrementIndexWrapped(size_t index) const
+				{
+					return index == 0 ? Capacity - 1 : index - 1;
+				};
+
+				inline constexpr size_t GetNextIndexIter(size_t index) const
+				{
+					// One step past the head is always the end - checked explicitly, since on a
+					// full ring every slot is valid and IsIndexValid alone could not stop the walk
+					if (index == InvalidIndex() || index == head)
+						return InvalidIndex();
+
+					if (tail > head)
+						index = IncrementIndexWrapped(index);
+					else
+						index++;
+
+					if (!IsIndexValid(index))
+						return InvalidIndex();
+
+					return index;
+				};
+
+				inline constexpr size_t GetPreviousIndexIter(size_t index) const
+				{
+					// Same reasoning - one step before the tail is always outside the range
+					if (index == InvalidIndex() || index == tail)
+						return InvalidIndex();
+
+					if (tail > head)
+						index = DecrementIndexWrapped(index);
+					else
+						index--;
+
+					if (!IsIndexValid(index))
+						return InvalidIndex();
+
+					return index;
+				};
+
+				inline constexpr size_t GetNextIndexIter(size_t index, size_t offset) const
+				{
+					// Map to the logical position, step there and map back - O(1) for any
+					// offset and immune to the wrap point
+					const size_t Logical = GetLogicalIndex(index);
+					if (Logical == InvalidIndex() || Logical + offset >= elementsInside)
+						return offset ? InvalidIndex() : index;
+
+					size_t SteppedIndex = tail + Logical + offset;
+					if (SteppedIndex >= Capacity)
+						SteppedIndex -= Capacity;
+
+					return SteppedIndex;
+				};
+
+				inline constexpr size_t GetPreviousIndexIter(size_t index, size_t offset) const
+				{
+					const size_t Logical = GetLogicalIndex(index);
+					if (Logical == InvalidIndex() || offset > Logical)
+						return offset ? InvalidIndex() : index;
+
+					size_t SteppedIndex = tail + Logical - offset;
+					if (SteppedIndex >= Capacity)
+						SteppedIndex -= Capacity;
+
+					return SteppedIndex;
+				};
+
+#ifdef RING_BUFFER_ENABLE_STATS
+				// Bumps the push-side counters; WrappedSeam marks an insertion that
+				// crossed the physical end of the storage array
+				inline constexpr void StatsOnPush(bool WrappedSeam)
+				{
+					stats.Pushes++;
+					if (WrappedSeam)
+						stats.Wraps++;
+					if (elementsInside > stats.HighWaterMark)
+						stats.HighWaterMark = elementsInside;
+				};
+#endif
+
+				ValueT Storage[Capacity] = {};
+				size_t head = InvalidIndex();
+				size_t tail = InvalidIndex();
+				size_t elementsInside = 0;
+#ifdef RING_BUFFER_ENABLE_STATS
+				RingBufferStats stats = {};
+#endif
+			};
+
+		};
+	};
+};
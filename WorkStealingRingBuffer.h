@@ -0,0 +1,290 @@
+#pragma once
+/// -----------------------------------------------------------------------------
+///
+/// BSD 3-Clause License
+/// Copyright(c) 2023-2024, (IHarzI) Maslianka Zakhar
+///
+/// -----------------------------------------------------------------------------
+
+#include "RingBuffer.h"
+
+#include <atomic>
+#include <utility>
+
+namespace harz {
+	namespace Containers {
+		namespace RingBufferImplementation {
+
+			// Chase-Lev work-stealing deque over a power-of-two ring, for per-worker task
+			// queues: the owner thread pushes and pops at the bottom without a lock or CAS
+			// on the common path, stealer threads take from the top with a single CAS.
+			// Compared to one mutexed shared RingBuffer, workers only ever contend when
+			// the deque is down to its last element or a steal actually happens.
+			// Memory ordering follows Le/Pop/Cohen/Nardelli "Correct and Efficient
+			// Work-Stealing for Weak Memory Models" (the C11 Chase-Lev).
+			// Grow (owner only) doubles the ring like RingBuffer's auto-growth, but the
+			// old block is retired, not freed - a stealer may still be reading it - and
+			// reclaimed when the deque is destroyed; with doubling the retired chain
+			// totals less than one current block.
+			// Value Type must be trivially copyable: a stealer copies the element out
+			// BEFORE its CAS confirms the claim, losers just discard the copy. That
+			// speculative read can race with an owner push refilling the cell - inherent
+			// to the plain-cell Chase-Lev and harmless, since the CAS rejects exactly
+			// the copies that could have been torn, but thread sanitizers will flag it
+#ifdef RING_BUFFER_USE_SIMPLE_ALLOCATOR
+			template<typename ValueT, typename AllocatorT = utils::TEST_SIMPLE_ALLOCATOR_FOR_RING_BUFFER>
+#else
+			template<typename ValueT, typename AllocatorT>
+#endif
+			class WorkStealingRingBuffer
+			{
+				static_assert(std::is_trivially_copyable_v<ValueT>,
+					"stealers copy elements before their claim is confirmed, ValueT must be trivially copyable");
+			public:
+				WorkStealingRingBuffer();
+				// Capacity is rounded up to a power of two
+				WorkStealingRingBuffer(size_t capacity);
+				~WorkStealingRingBuffer();
+
+				// Not copyable/movable, other threads could be stealing while we copy
+				WorkStealingRingBuffer(const WorkStealingRingBuffer&) = delete;
+				WorkStealingRingBuffer& operator=(const WorkStealingRingBuffer&) = delete;
+
+				// Push element at the bottom. Owner thread only.
+				// Grows (doubling) when full; returns false if the allocation failed
+				bool PushBottom(ValueT value);
+
+				// Pop the most recently pushed element (LIFO for the owner - the hot task,
+				// still cache-warm). Owner thread only. Returns false if the deque is
+				// empty or the last element lost a race against a stealer
+				bool PopBottom(ValueT& OutValue);
+
+				// Take the oldest element from the top. Any thread. One CAS; returns
+				// false if the deque looks empty or another thief won the race
+				bool TrySteal(ValueT& OutValue);
+
+				// Get capacity of the current block
+				inline size_t GetCapacity() const
+				{
+					StorageBlock* Block = storage.load(std::memory_order_acquire);
+					return Block ? Block->Mask + 1 : 0;
+				};
+
+				// Get number of elements inside. Only an estimate while other threads steal
+				inline size_t GetSize() const
+				{
+					const size_t CurrentBottom = bottom.load(std::memory_order_acquire);
+					const size_t CurrentTop = top.load(std::memory_order_acquire);
+					return CurrentBottom > CurrentTop ? CurrentBottom - CurrentTop : 0;
+				};
+
+				inline bool IsEmpty() const { return GetSize() == 0; };
+
+				inline const size_t InvalidIndex() const { return size_t(-1); };
+
+#ifdef RING_BUFFER_ENABLE_STATS
+				// Snapshot/reset of the traffic counters, only compiled in with RING_BUFFER_ENABLE_STATS.
+				// Owner pops and successful steals both count as Pops
+				inline RingBufferStats GetStats() const { return stats.Snapshot(); };
+				inline void ResetStats() { stats.Reset(); };
+#endif
+
+			private:
+				// Mask and cells live together so a stealer resolves both with one
+				// pointer load; retired blocks chain through Retired until destruction
+				struct StorageBlock
+				{
+					size_t Mask = 0;
+					StorageBlock* Retired = nullptr;
+
+					inline ValueT* Cells() { return (ValueT*)(this + 1); };
+				};
+
+				StorageBlock* AllocateBlock(size_t CellsCount);
+
+				// Double the ring and move the live range over. Owner thread only,
+				// called from a full PushBottom
+				bool Grow();
+
+				static const size_t CacheLineSize = RING_BUFFER_CACHE_LINE_SIZE;
+
+				AllocatorT m_InternalAllocator = AllocatorT{};
+				std::atomic<StorageBlock*> storage = nullptr;
+				// Owner-only chain of outgrown blocks, freed in the destructor
+				StorageBlock* retiredBlocks = nullptr;
+
+				// Owner-written index one past the newest element, on its own cache line
+				alignas(CacheLineSize) std::atomic<size_t> bottom = 0;
+				// CAS'd index of the oldest element, on its own cache line
+				alignas(CacheLineSize) std::atomic<size_t> top = 0;
+				char PadAfterIndices[CacheLineSize - sizeof(std::atomic<size_t>)] = {};
+
+#ifdef RING_BUFFER_ENABLE_STATS
+				RingBufferAtomicStats stats = {};
+#endif
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			WorkStealingRingBuffer<ValueT, AllocatorT>::WorkStealingRingBuffer()
+			{
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			WorkStealingRingBuffer<ValueT, AllocatorT>::WorkStealingRingBuffer(size_t capacity)
+			{
+				if (capacity > 0 && capacity != InvalidIndex())
+					storage.store(AllocateBlock(detail::RoundUpToPowerOfTwo(capacity)), std::memory_order_relaxed);
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			WorkStealingRingBuffer<ValueT, AllocatorT>::~WorkStealingRingBuffer()
+			{
+				StorageBlock* Block = storage.load(std::memory_order_relaxed);
+				if (Block)
+					m_InternalAllocator.Deallocate(Block);
+				while (retiredBlocks)
+				{
+					StorageBlock* Retired = retiredBlocks;
+					retiredBlocks = Retired->Retired;
+					m_InternalAllocator.Deallocate(Retired);
+				};
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			WorkStealingRingBuffer<ValueT, AllocatorT>::StorageBlock* WorkStealingRingBuffer<ValueT, AllocatorT>::AllocateBlock(size_t CellsCount)
+			{
+				StorageBlock* Block = (StorageBlock*)m_InternalAllocator.Allocate(sizeof(StorageBlock) + CellsCount * sizeof(ValueT));
+				if (Block)
+				{
+					Block->Mask = CellsCount - 1;
+					Block->Retired = nullptr;
+				};
+				return Block;
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			bool WorkStealingRingBuffer<ValueT, AllocatorT>::Grow()
+			{
+				StorageBlock* OldBlock = storage.load(std::memory_order_relaxed);
+				const size_t NewCellsCount = OldBlock ? (OldBlock->Mask + 1) * 2 : 8;
+
+				StorageBlock* NewBlock = AllocateBlock(NewCellsCount);
+				if (!NewBlock)
+					return false;
+
+				if (OldBlock)
+				{
+					// Only the owner moves cells; stealers racing on the old block either
+					// claimed their slot before we publish the new one or retry on fresh
+					// top/bottom and load the new block pointer
+					const size_t CurrentTop = top.load(std::memory_order_relaxed);
+					const size_t CurrentBottom = bottom.load(std::memory_order_relaxed);
+					for (size_t Index = CurrentTop; Index != CurrentBottom; Index++)
+						NewBlock->Cells()[Index & NewBlock->Mask] = OldBlock->Cells()[Index & OldBlock->Mask];
+
+					OldBlock->Retired = retiredBlocks;
+					retiredBlocks = OldBlock;
+				};
+
+				storage.store(NewBlock, std::memory_order_release);
+				RING_BUFFER_STAT(stats.Resizes.fetch_add(1, std::memory_order_relaxed))
+				return true;
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			bool WorkStealingRingBuffer<ValueT, AllocatorT>::PushBottom(ValueT value)
+			{
+				const size_t CurrentBottom = bottom.load(std::memory_order_relaxed);
+				const size_t CurrentTop = top.load(std::memory_order_acquire);
+				StorageBlock* Block = storage.load(std::memory_order_relaxed);
+
+				if (!Block || CurrentBottom - CurrentTop > Block->Mask)
+				{
+					if (!Grow())
+					{
+						RING_BUFFER_STAT(stats.FailedPushes.fetch_add(1, std::memory_order_relaxed))
+						return false;
+					};
+					Block = storage.load(std::memory_order_relaxed);
+				};
+
+				Block->Cells()[CurrentBottom & Block->Mask] = std::move(value);
+
+				// Publish the cell before the new bottom becomes visible to stealers
+				std::atomic_thread_fence(std::memory_order_release);
+				bottom.store(CurrentBottom + 1, std::memory_order_relaxed);
+				RING_BUFFER_STAT(stats.Pushes.fetch_add(1, std::memory_order_relaxed))
+				RING_BUFFER_STAT(stats.UpdateHighWaterMark(GetSize()))
+				return true;
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			bool WorkStealingRingBuffer<ValueT, AllocatorT>::PopBottom(ValueT& OutValue)
+			{
+				// Cheap empty check first - top only ever grows, so an equal pair can
+				// only get "more empty", and it keeps the reservation below from
+				// wrapping bottom under zero
+				if (bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed))
+					return false;
+
+				const size_t NewBottom = bottom.load(std::memory_order_relaxed) - 1;
+				StorageBlock* Block = storage.load(std::memory_order_relaxed);
+
+				// Reserve the bottom cell, then look at the top: the fence orders our
+				// reservation against concurrent steals claiming the same last element
+				bottom.store(NewBottom, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				size_t CurrentTop = top.load(std::memory_order_relaxed);
+
+				if (CurrentTop < NewBottom)
+				{
+					// More than one element left, the reserved cell is ours outright
+					OutValue = Block->Cells()[NewBottom & Block->Mask];
+					RING_BUFFER_STAT(stats.Pops.fetch_add(1, std::memory_order_relaxed))
+					return true;
+				};
+
+				bool Claimed = false;
+				if (CurrentTop == NewBottom)
+				{
+					// Last element - settle it with the same CAS a stealer would use
+					Claimed = top.compare_exchange_strong(CurrentTop, CurrentTop + 1,
+						std::memory_order_seq_cst, std::memory_order_relaxed);
+					if (Claimed)
+						OutValue = Block->Cells()[NewBottom & Block->Mask];
+				};
+
+				// Empty (or lost the race) - give the reservation back
+				bottom.store(NewBottom + 1, std::memory_order_relaxed);
+				RING_BUFFER_STAT(if (Claimed) stats.Pops.fetch_add(1, std::memory_order_relaxed))
+				return Claimed;
+			};
+
+			template<typename ValueT, typename AllocatorT>
+			bool WorkStealingRingBuffer<ValueT, AllocatorT>::TrySteal(ValueT& OutValue)
+			{
+				const size_t CurrentTop = top.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				const size_t CurrentBottom = bottom.load(std::memory_order_acquire);
+
+				if (CurrentTop >= CurrentBottom)
+					return false;
+
+				// Copy out first - the CAS decides afterwards whether the copy counts,
+				// which is why ValueT has to be trivially copyable
+				StorageBlock* Block = storage.load(std::memory_order_acquire);
+				ValueT Stolen = Block->Cells()[CurrentTop & Block->Mask];
+
+				size_t Expected = CurrentTop;
+				if (!top.compare_exchange_strong(Expected, CurrentTop + 1,
+					std::memory_order_seq_cst, std::memory_order_relaxed))
+					return false;
+
+				OutValue = Stolen;
+				RING_BUFFER_STAT(stats.Pops.fetch_add(1, std::memory_order_relaxed))
+				return true;
+			};
+
+		};
+	};
+};
@@ -0,0 +1,223 @@
+/// -----------------------------------------------------------------------------
+///
+/// BSD 3-Clause License
+/// Copyright(c) 2023-2024, (IHarzI) Maslianka Zakhar
+///
+/// Throughput benchmarks for RingBuffer against std::deque (and
+/// boost::circular_buffer when available). Covers push/pop across element
+/// sizes, wrap-heavy iteration, Resize cost and mixed steady-state traffic.
+///
+/// -----------------------------------------------------------------------------
+
+#define RING_BUFFER_USE_SIMPLE_ALLOCATOR
+#include "RingBuffer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <deque>
+
+#ifdef RING_BUFFER_BENCH_HAVE_BOOST
+#include <boost/circular_buffer.hpp>
+#endif
+
+namespace {
+
+	constexpr size_t RingCapacity = 1024;
+
+	// Payload of a controllable size, 8B .. 1KB in the registrations below
+	template<size_t Size>
+	struct Element
+	{
+		unsigned char Bytes[Size] = {};
+	};
+
+	using harz::Containers::RingBufferImplementation::RingBuffer;
+	using harz::Containers::RingBufferImplementation::RingBufferPow2;
+
+	template<size_t Size>
+	void BM_RingBuffer_PushBackPopFront(benchmark::State& state)
+	{
+		RingBuffer<Element<Size>> Ring(RingCapacity);
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < RingCapacity; i++)
+				Ring.PushBack(Element<Size>{});
+			for (size_t i = 0; i < RingCapacity; i++)
+				benchmark::DoNotOptimize(Ring.PopFront());
+		}
+		state.SetItemsProcessed(state.iterations() * RingCapacity);
+		state.SetBytesProcessed(state.iterations() * RingCapacity * Size);
+	}
+
+	template<size_t Size>
+	void BM_RingBufferPow2_PushBackPopFront(benchmark::State& state)
+	{
+		RingBufferPow2<Element<Size>> Ring(RingCapacity);
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < RingCapacity; i++)
+				Ring.PushBack(Element<Size>{});
+			for (size_t i = 0; i < RingCapacity; i++)
+				benchmark::DoNotOptimize(Ring.PopFront());
+		}
+		state.SetItemsProcessed(state.iterations() * RingCapacity);
+		state.SetBytesProcessed(state.iterations() * RingCapacity * Size);
+	}
+
+	template<size_t Size>
+	void BM_Deque_PushBackPopFront(benchmark::State& state)
+	{
+		std::deque<Element<Size>> Deque;
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < RingCapacity; i++)
+				Deque.push_back(Element<Size>{});
+			for (size_t i = 0; i < RingCapacity; i++)
+			{
+				benchmark::DoNotOptimize(Deque.front());
+				Deque.pop_front();
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * RingCapacity);
+		state.SetBytesProcessed(state.iterations() * RingCapacity * Size);
+	}
+
+#ifdef RING_BUFFER_BENCH_HAVE_BOOST
+	template<size_t Size>
+	void BM_BoostCircular_PushBackPopFront(benchmark::State& state)
+	{
+		boost::circular_buffer<Element<Size>> Circular(RingCapacity);
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < RingCapacity; i++)
+				Circular.push_back(Element<Size>{});
+			for (size_t i = 0; i < RingCapacity; i++)
+			{
+				benchmark::DoNotOptimize(Circular.front());
+				Circular.pop_front();
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * RingCapacity);
+		state.SetBytesProcessed(state.iterations() * RingCapacity * Size);
+	}
+#endif
+
+	// Wrap-heavy iteration: the occupied range straddles the wrap point, so every
+	// full pass steps TIndexedIteratorBase::Increment across the seam
+	template<typename RingT>
+	void IterationBenchBody(benchmark::State& state)
+	{
+		RingT Ring(RingCapacity);
+		for (size_t i = 0; i < RingCapacity; i++)
+			Ring.PushBack(Element<64>{});
+		for (size_t i = 0; i < RingCapacity / 2; i++)
+			Ring.PopFront();
+		for (size_t i = 0; i < RingCapacity / 2; i++)
+			Ring.PushBack(Element<64>{});
+
+		for (auto _ : state)
+		{
+			size_t Visited = 0;
+			for (auto& element : Ring)
+			{
+				benchmark::DoNotOptimize(element);
+				Visited++;
+			}
+			benchmark::DoNotOptimize(Visited);
+		}
+		state.SetItemsProcessed(state.iterations() * RingCapacity);
+	}
+
+	void BM_RingBuffer_WrappedIteration(benchmark::State& state)
+	{
+		IterationBenchBody<RingBuffer<Element<64>>>(state);
+	}
+
+	void BM_RingBufferPow2_WrappedIteration(benchmark::State& state)
+	{
+		IterationBenchBody<RingBufferPow2<Element<64>>>(state);
+	}
+
+	void BM_RingBuffer_Resize(benchmark::State& state)
+	{
+		const size_t StartCapacity = static_cast<size_t>(state.range(0));
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			RingBuffer<Element<64>> Ring(StartCapacity);
+			for (size_t i = 0; i < StartCapacity; i++)
+				Ring.PushBack(Element<64>{});
+			state.ResumeTiming();
+
+			Ring.Resize(StartCapacity * 2);
+			benchmark::DoNotOptimize(Ring.GetCapacity());
+		}
+		state.SetItemsProcessed(state.iterations() * StartCapacity);
+	}
+
+	// Mixed steady state: the ring stays around half full while small bursts of
+	// pushes and pops alternate, the pattern our ingest pipelines actually run
+	template<typename ContainerT>
+	void MixedBenchBody(benchmark::State& state, ContainerT& Container)
+	{
+		for (size_t i = 0; i < RingCapacity / 2; i++)
+			Container.PushBack(Element<64>{});
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < 4; i++)
+				Container.PushBack(Element<64>{});
+			for (size_t i = 0; i < 4; i++)
+				benchmark::DoNotOptimize(Container.PopFront());
+		}
+		state.SetItemsProcessed(state.iterations() * 8);
+	}
+
+	void BM_RingBuffer_MixedSteadyState(benchmark::State& state)
+	{
+		RingBuffer<Element<64>> Ring(RingCapacity);
+		MixedBenchBody(state, Ring);
+	}
+
+	void BM_Deque_MixedSteadyState(benchmark::State& state)
+	{
+		std::deque<Element<64>> Deque;
+		for (size_t i = 0; i < RingCapacity / 2; i++)
+			Deque.push_back(Element<64>{});
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < 4; i++)
+				Deque.push_back(Element<64>{});
+			for (size_t i = 0; i < 4; i++)
+			{
+				benchmark::DoNotOptimize(Deque.front());
+				Deque.pop_front();
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * 8);
+	}
+
+	BENCHMARK(BM_RingBuffer_PushBackPopFront<8>);
+	BENCHMARK(BM_RingBuffer_PushBackPopFront<64>);
+	BENCHMARK(BM_RingBuffer_PushBackPopFront<256>);
+	BENCHMARK(BM_RingBuffer_PushBackPopFront<1024>);
+	BENCHMARK(BM_RingBufferPow2_PushBackPopFront<8>);
+	BENCHMARK(BM_RingBufferPow2_PushBackPopFront<64>);
+	BENCHMARK(BM_RingBufferPow2_PushBackPopFront<256>);
+	BENCHMARK(BM_RingBufferPow2_PushBackPopFront<1024>);
+	BENCHMARK(BM_Deque_PushBackPopFront<8>);
+	BENCHMARK(BM_Deque_PushBackPopFront<64>);
+	BENCHMARK(BM_Deque_PushBackPopFront<256>);
+	BENCHMARK(BM_Deque_PushBackPopFront<1024>);
+#ifdef RING_BUFFER_BENCH_HAVE_BOOST
+	BENCHMARK(BM_BoostCircular_PushBackPopFront<8>);
+	BENCHMARK(BM_BoostCircular_PushBackPopFront<64>);
+	BENCHMARK(BM_BoostCircular_PushBackPopFront<256>);
+	BENCHMARK(BM_BoostCircular_PushBackPopFront<1024>);
+#endif
+	BENCHMARK(BM_RingBuffer_WrappedIteration);
+	BENCHMARK(BM_RingBufferPow2_WrappedIteration);
+	BENCHMARK(BM_RingBuffer_Resize)->Arg(1024)->Arg(16384)->Arg(131072);
+	BENCHMARK(BM_RingBuffer_MixedSteadyState);
+	BENCHMARK(BM_Deque_MixedSteadyState);
+
+};